@@ -2,6 +2,7 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -53,6 +54,19 @@ typedef struct {
 	uint8_t d; // Dia.
 } Date;
 
+// Nome guardado inline, sem alocação, quando tem até `NOME_INLINE` bytes. O
+// último byte de `buf` guarda quantos bytes sobram no buffer: assim, um nome
+// de exatamente `NOME_INLINE` bytes usa esse byte, que vale zero, como
+// terminador. Nomes maiores ficam no heap, apontados por `ptr`, e o último
+// byte vale `NOME_HEAP`.
+#define NOME_INLINE 23 // Tamanho máximo de um nome guardado inline.
+#define NOME_HEAP UINT8_MAX // Marca de nome guardado no heap.
+
+typedef union {
+	char buf[NOME_INLINE + 1]; // Nome e bytes restantes, se couber.
+	char *ptr; // String dinâmica, se não couber.
+} NomeCurto;
+
 // O Pokémon em si. Usamos tipos numéricos rígidos para economizar memória.
 typedef struct {
 	// Ordenamos os membros de maior (8 bytes) para menor (1 byte) para
@@ -63,8 +77,10 @@ typedef struct {
 	double weight; // Peso em quilogramas.
 	double height; // Altura em metros.
 
+	// Nome curto, alinhado como ponteiro (24 bytes).
+	NomeCurto name; // Nome, inline se for curto.
+
 	// Ponteiros de 32 ou 64 bits, dependendo da máquina.
-	char *name; // String dinâmica para o nome.
 	char *description; // String dinâmica para a descrição.
 
 	// Tipos de 32 bits.
@@ -84,13 +100,60 @@ typedef struct {
 	PokeAbilities abilities; // Lista dinâmica das habilidades.
 } Pokemon;
 
-// Lista sequencial de Pokémon.
+// Lista sequencial de Pokémon, guardada em um arranjo circular: a posição
+// lógica `i` fica em `arr[(inicio + i) & (cap - 1)]`, de modo que inserções e
+// remoções em ambas as pontas não deslocam nenhum elemento. Cada elemento é o
+// índice do Pokémon no catálogo, e não um clone, de modo que inserir, remover
+// e deslocar elementos só movem inteiros de 4 bytes.
 typedef struct {
-	Pokemon **arr; // Array de ponteiros.
-	int cap; // Capacidade do array.
+	uint32_t *arr; // Array circular de índices no catálogo.
+	int cap; // Capacidade do array (zero ou potência de dois).
 	int n; // Número de elementos logicamente na lista.
+	int inicio; // Índice no array do primeiro elemento.
 } ListaPokemon;
 
+#define CAP_MIN 8 // Capacidade do arranjo ao crescer a partir de vazio.
+
+// Índice de nomes: tabela de espalhamento com endereçamento aberto e sondagem
+// linear, que associa cada nome à posição do Pokémon no catálogo. A tabela
+// fica no máximo meio cheia, então uma busca compara, em média, pouco mais de
+// um nome.
+typedef struct {
+	uint32_t *slots; // Posições no catálogo, ou VAZIO.
+	uint32_t mascara; // Tamanho da tabela menos um (potência de dois).
+	Pokemon **catalogo; // Catálogo indexado.
+} IndiceNomes;
+
+#define VAZIO UINT32_MAX // Slot vazio no índice de nomes.
+#define TAM_ARG 256 // Tamanho máximo do argumento de um comando.
+
+// Converte o valor de uma macro em string, para usá-lo em formatos.
+#define STR(x) #x
+#define XSTR(x) STR(x)
+
+// Índice de bits: para cada valor de tipo, de geração e de lendário, um
+// conjunto de bits com um bit por Pokémon no catálogo. Os filtros combinam os
+// conjuntos uma palavra de 64 bits por vez, e contam o resultado com popcount,
+// sem percorrer os Pokémon. Os conjuntos ficam em um único bloco, e são
+// identificados pelos números abaixo.
+#define NUM_TIPOS (WATER + 1) // Conjuntos de tipo, inclusive NO_TYPE.
+#define MAX_GERACAO 8 // Maior geração indexada.
+#define CONJ_GERACAO NUM_TIPOS // Primeiro conjunto de geração (geração 0).
+#define CONJ_LENDARIO (CONJ_GERACAO + MAX_GERACAO + 1) // Lendários.
+#define CONJ_TODOS (CONJ_LENDARIO + 1) // Todos os Pokémon do catálogo.
+#define NUM_CONJ (CONJ_TODOS + 1) // Número de conjuntos.
+
+typedef struct {
+	uint64_t *bits; // Conjuntos, cada um com `palavras` palavras.
+	int palavras; // Palavras de 64 bits por conjunto.
+} IndiceBits;
+
+// Estado da leitura de um filtro: o token atual e o resto da string.
+typedef struct {
+	char *tok; // Token atual, ou NULL no fim do filtro.
+	char *sav; // Ponteiro auxiliar para o estado de `strtok_r()`.
+} Filtro;
+
 /// Declarações de todas as funções. //////////////////////////////////////////
 
 // Funções para cumprimento da questão.
@@ -111,16 +174,49 @@ void pokemon_free(Pokemon *restrict p);
 static PokeAbilities abilities_from_string(char *str);
 static PokeType type_from_string(const char *str);
 static const char *type_to_string(PokeType type);
+static void nome_init(NomeCurto *n, const char *str);
+static inline bool nome_no_heap(const NomeCurto *n);
+static inline const char *nome_str(const NomeCurto *n);
+static void nome_free(NomeCurto *n);
 
 // Funções para a implementação da lista.
+static inline int lista_idx(const ListaPokemon *l, int pos);
 void lista_init(ListaPokemon *l, int capacidade);
+void lista_reserve(ListaPokemon *l, int capacidade);
+static void lista_cresce(ListaPokemon *l);
+static void lista_move(ListaPokemon *l, int para, int de, int num);
 void lista_free(ListaPokemon *l);
-void inserir(ListaPokemon *l, Pokemon *x, int pos);
-void inserir_inicio(ListaPokemon *l, Pokemon *x);
-void inserir_fim(ListaPokemon *l, Pokemon *x);
-Pokemon *remover(ListaPokemon *l, int pos);
-Pokemon *remover_inicio(ListaPokemon *l);
-Pokemon *remover_fim(ListaPokemon *l);
+void inserir(ListaPokemon *l, uint32_t x, int pos);
+void inserir_inicio(ListaPokemon *l, uint32_t x);
+void inserir_fim(ListaPokemon *l, uint32_t x);
+uint32_t remover(ListaPokemon *l, int pos);
+uint32_t remover_inicio(ListaPokemon *l);
+uint32_t remover_fim(ListaPokemon *l);
+int lista_busca(const ListaPokemon *l, uint32_t x);
+
+// Funções para a implementação do índice de nomes.
+static uint32_t hash_nome(const char *str);
+void indice_init(IndiceNomes *ind, Pokemon **catalogo, int num);
+void indice_free(IndiceNomes *ind);
+int indice_busca(const IndiceNomes *ind, const char *nome);
+static void ler_arg(char *arg, const char *cmd);
+static int ler_pokemon(const IndiceNomes *ind, int num, char *arg);
+
+// Funções para a implementação do índice de bits e dos filtros.
+void bits_init(IndiceBits *ind, Pokemon **catalogo, int num);
+void bits_free(IndiceBits *ind);
+static inline uint64_t *bits_conj(const IndiceBits *ind, int conj);
+static int bits_conta(const uint64_t *a, int palavras);
+static void imprimir_nomes(Pokemon **catalogo, const uint64_t *a,
+			   int palavras);
+static int conj_from_string(const char *str);
+static void filtro_avanca(Filtro *f);
+static void filtro_ou(const IndiceBits *ind, Filtro *f, uint64_t *res);
+static void filtro_e(const IndiceBits *ind, Filtro *f, uint64_t *res);
+static void filtro_nao(const IndiceBits *ind, Filtro *f, uint64_t *res);
+void filtrar(const IndiceBits *ind, char *str, uint64_t *res);
+static void mostrar_filtro(const IndiceBits *ind, Pokemon **catalogo,
+			   char cmd, char *str);
 
 /// Métodos que operam nos Pokémon. ///////////////////////////////////////////
 
@@ -148,7 +244,7 @@ void ler(Pokemon *restrict p, char *str)
 
 	// Lê o nome.
 	tok = strtok_r(NULL, ",", &sav);
-	p->name = strdup(tok);
+	nome_init(&p->name, tok);
 
 	// Lê a descrição.
 	tok = strtok_r(NULL, ",", &sav);
@@ -196,8 +292,8 @@ void ler(Pokemon *restrict p, char *str)
 // Printa um Pokémon recebido por referência em `stdout`.
 void imprimir(Pokemon *restrict const p)
 {
-	printf("[#%d -> %s: %s - ['%s'", p->id, p->name, p->description,
-	       type_to_string(p->type[0]));
+	printf("[#%d -> %s: %s - ['%s'", p->id, nome_str(&p->name),
+	       p->description, type_to_string(p->type[0]));
 
 	if (p->type[1] != NO_TYPE)
 		printf(", '%s'", type_to_string(p->type[1]));
@@ -237,7 +333,6 @@ Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
 
 	*res = (Pokemon){ .id = id,
 			  .generation = generation,
-			  .name = strdup(name),
 			  .description = strdup(description),
 			  .type[0] = type[0],
 			  .type[1] = type[1],
@@ -247,13 +342,14 @@ Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
 			  .capture_rate = capture_rate,
 			  .is_legendary = is_legendary,
 			  .capture_date = capture_date };
+	nome_init(&res->name, name);
 	return res;
 }
 
 // Duplica um Pokemón.
 Pokemon *pokemon_clone(const Pokemon *p)
 {
-	return pokemon_from_params(p->id, p->generation, p->name,
+	return pokemon_from_params(p->id, p->generation, nome_str(&p->name),
 				   p->description, p->type, &p->abilities,
 				   p->weight, p->height, p->capture_rate,
 				   p->is_legendary, p->capture_date);
@@ -275,7 +371,7 @@ static inline Pokemon *pokemon_new(void)
 void pokemon_free(Pokemon *restrict p)
 {
 	if (p != NULL) {
-		free(p->name);
+		nome_free(&p->name);
 		free(p->description);
 		for (int i = 0; i < p->abilities.num; ++i)
 			free(p->abilities.list[i]);
@@ -470,82 +566,195 @@ static const char *type_to_string(PokeType type)
 	return res;
 }
 
+/// Métodos que operam nos nomes curtos. //////////////////////////////////////
+
+// Guarda uma cópia de `str`, inline se couber.
+static void nome_init(NomeCurto *n, const char *str)
+{
+	size_t tam = strlen(str);
+
+	if (tam <= NOME_INLINE) {
+		memcpy(n->buf, str, tam);
+		n->buf[tam] = '\0';
+		n->buf[NOME_INLINE] = NOME_INLINE - tam;
+		return;
+	}
+
+	n->buf[NOME_INLINE] = (char)NOME_HEAP;
+	n->ptr = strdup(str);
+	if (!n->ptr) {
+		int errsv = errno;
+		perror("Impossível alocar memória para nome");
+		exit(errsv);
+	}
+}
+
+static inline bool nome_no_heap(const NomeCurto *n)
+{
+	return (uint8_t)n->buf[NOME_INLINE] == NOME_HEAP;
+}
+
+// Retorna o nome como string terminada em nulo.
+static inline const char *nome_str(const NomeCurto *n)
+{
+	return nome_no_heap(n) ? n->ptr : n->buf;
+}
+
+static void nome_free(NomeCurto *n)
+{
+	if (nome_no_heap(n))
+		free(n->ptr);
+	memset(n, 0, sizeof(*n));
+}
+
 /// Métodos que operam na lista sequencial de Pokémon. ////////////////////////
 
-// Instancia uma lista de Pokémon.
+// Converte uma posição lógica da lista no índice correspondente do arranjo
+// circular. Aceita também a posição -1, logo antes do primeiro elemento.
+static inline int lista_idx(const ListaPokemon *l, int pos)
+{
+	return (unsigned)(l->inicio + pos) & (l->cap - 1);
+}
+
+// Instancia uma lista de Pokémon. A capacidade inicial é só uma sugestão: o
+// arranjo cresce sob demanda.
 void lista_init(ListaPokemon *l, int capacidade)
 {
-	*l = (ListaPokemon){ .arr = malloc(sizeof(Pokemon *[capacidade])),
-			     .cap = capacidade,
-			     .n = 0 };
+	*l = (ListaPokemon){ .arr = NULL, .cap = 0, .n = 0, .inicio = 0 };
+	lista_reserve(l, capacidade);
+}
+
+// Garante que o arranjo comporte ao menos `capacidade` elementos sem precisar
+// crescer de novo. Útil antes de inserir muitos elementos de uma vez.
+void lista_reserve(ListaPokemon *l, int capacidade)
+{
+	uint32_t *arr;
+	int cap = l->cap ? l->cap : CAP_MIN;
+	int prim; // Número de elementos até o fim físico do arranjo antigo.
+
+	if (capacidade <= l->cap)
+		return;
+
+	// Arredonda a capacidade para uma potência de dois.
+	while (cap < capacidade) {
+		if (cap > INT_MAX / 2) {
+			fputs("O arranjo da lista atingiu o tamanho máximo.\n",
+			      stderr);
+			exit(EXIT_FAILURE);
+		}
+		cap *= 2;
+	}
+
+	arr = malloc(cap * sizeof(uint32_t));
 
 	// Trata erro na alocação.
-	if (l->arr == NULL) {
+	if (arr == NULL) {
 		int errsv = errno;
 		perror("Impossível alocar memória para array de Pokémon");
 		exit(errsv);
 	}
 
-	memset(l->arr, 0, sizeof(Pokemon *[capacidade]));
+	// Copia os elementos para o início do novo arranjo, desfazendo a volta.
+	if (l->n) {
+		prim = l->cap - l->inicio < l->n ? l->cap - l->inicio : l->n;
+		memcpy(arr, l->arr + l->inicio, prim * sizeof(uint32_t));
+		memcpy(arr + prim, l->arr, (l->n - prim) * sizeof(uint32_t));
+	}
+
+	free(l->arr);
+	l->arr = arr;
+	l->cap = cap;
+	l->inicio = 0;
 }
 
-// Libera a lista de Pokémon, e todos os Pokémon contidos.
-void lista_free(ListaPokemon *l)
+// Dobra a capacidade do arranjo, garantindo inserção em O(1) amortizado.
+static void lista_cresce(ListaPokemon *l)
+{
+	if (l->cap > INT_MAX / 2) {
+		fputs("O arranjo da lista atingiu o tamanho máximo.\n",
+		      stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	lista_reserve(l, l->cap ? 2 * l->cap : CAP_MIN);
+}
+
+// Move `num` elementos das posições lógicas a partir de `de` para as posições
+// a partir de `para`. Como o arranjo é circular, cada trecho contíguo (no
+// máximo três) é movido com um `memmove()` separado.
+static void lista_move(ListaPokemon *l, int para, int de, int num)
 {
-	// Libera Pokémon no arranjo.
-	for (int i = 0; i < l->cap; ++i) {
-		Pokemon *ptr = l->arr[i];
-		if (ptr) {
-			pokemon_free(ptr);
-
-			// Para cada ponteiro liberado, é necessário buscar
-			// sequencialmente por quaisquer outros ponteiros
-			// iguais, que podem ter sido duplicados por ordenação
-			// parcial, e fazê-los nulos para evitar double free.
-			for (int j = i; j < l->cap; ++j)
-				if (l->arr[j] == ptr)
-					l->arr[j] = NULL;
+	while (num > 0) {
+		int i, j, k; // Origem, destino e tamanho do trecho.
+
+		if (para < de) {
+			// Move para a esquerda, do primeiro trecho ao último.
+			i = lista_idx(l, de);
+			j = lista_idx(l, para);
+			k = num;
+			k = (l->cap - i < k) ? l->cap - i : k;
+			k = (l->cap - j < k) ? l->cap - j : k;
+			memmove(l->arr + j, l->arr + i, k * sizeof(uint32_t));
+			de += k;
+			para += k;
+		} else {
+			// Move para a direita, do último trecho ao primeiro.
+			i = lista_idx(l, de + num - 1);
+			j = lista_idx(l, para + num - 1);
+			k = num;
+			k = (i + 1 < k) ? i + 1 : k;
+			k = (j + 1 < k) ? j + 1 : k;
+			memmove(l->arr + j - k + 1, l->arr + i - k + 1,
+				k * sizeof(uint32_t));
 		}
+
+		num -= k;
 	}
+}
 
+// Libera a lista. Os Pokémon pertencem ao catálogo, e não são liberados.
+void lista_free(ListaPokemon *l)
+{
 	// Libera o arranjo e zera os campos do struct.
 	free(l->arr);
 	memset(l, 0, sizeof(*l));
 }
 
-// Funções de inserção na lista. O Pokémon inserido é duplicado.
-void inserir(ListaPokemon *l, Pokemon *x, int pos)
+// Funções de inserção na lista. Apenas o índice do Pokémon é guardado.
+void inserir(ListaPokemon *l, uint32_t x, int pos)
 {
 	if (pos < 0 || pos > l->n) {
 		fprintf(stderr, "Posição %d é inválida.\n", pos);
 		exit(EXIT_FAILURE);
 	}
-	if (l->n == l->cap) {
-		fputs("O arranjo da lista está cheio.\n", stderr);
-		exit(EXIT_FAILURE);
-	}
+	if (l->n == l->cap)
+		lista_cresce(l);
 
-	// Desloca os elementos necessários à direita.
-	for (int i = l->n; i > pos; --i)
-		l->arr[i] = l->arr[i - 1];
+	// Abre espaço deslocando os elementos do lado mais próximo da posição.
+	if (pos < l->n - pos) {
+		l->inicio = lista_idx(l, -1);
+		lista_move(l, 0, 1, pos);
+	} else {
+		lista_move(l, pos + 1, pos, l->n - pos);
+	}
 
 	// Insere o elemento e incrementa `n`.
-	l->arr[pos] = pokemon_clone(x);
+	l->arr[lista_idx(l, pos)] = x;
 	l->n += 1;
 }
 
-void inserir_inicio(ListaPokemon *l, Pokemon *x)
+void inserir_inicio(ListaPokemon *l, uint32_t x)
 {
 	inserir(l, x, 0);
 }
 
-void inserir_fim(ListaPokemon *l, Pokemon *x)
+void inserir_fim(ListaPokemon *l, uint32_t x)
 {
 	inserir(l, x, l->n);
 }
 
-// Funções de remoção da lista.
-Pokemon *remover(ListaPokemon *l, int pos)
+// Funções de remoção da lista. Retornam o índice do Pokémon removido.
+uint32_t remover(ListaPokemon *l, int pos)
 {
 	if (pos < 0 || pos >= l->n) {
 		fprintf(stderr, "Posição %d é inválida.\n", pos);
@@ -556,27 +765,329 @@ Pokemon *remover(ListaPokemon *l, int pos)
 		exit(EXIT_FAILURE);
 	}
 
-	Pokemon *res = l->arr[pos];
+	uint32_t res = l->arr[lista_idx(l, pos)];
 
-	// Desloca os elementos à esquerda.
-	for (int i = pos; i < l->n - 1; ++i)
-		l->arr[i] = l->arr[i + 1];
+	// Fecha a lacuna deslocando os elementos do lado mais próximo.
+	if (pos < l->n - 1 - pos) {
+		lista_move(l, 1, 0, pos);
+		l->inicio = lista_idx(l, 1);
+	} else {
+		lista_move(l, pos, pos + 1, l->n - 1 - pos);
+	}
 
-	l->arr[l->n - 1] = NULL; // Limpa o último elemento.
 	l->n -= 1;
 	return res;
 }
 
-Pokemon *remover_inicio(ListaPokemon *l)
+uint32_t remover_inicio(ListaPokemon *l)
 {
 	return remover(l, 0);
 }
 
-Pokemon *remover_fim(ListaPokemon *l)
+uint32_t remover_fim(ListaPokemon *l)
 {
 	return remover(l, l->n - 1);
 }
 
+// Retorna a primeira posição do Pokémon de índice `x` na lista, ou -1.
+int lista_busca(const ListaPokemon *l, uint32_t x)
+{
+	for (int i = 0; i < l->n; ++i)
+		if (l->arr[lista_idx(l, i)] == x)
+			return i;
+
+	return -1;
+}
+
+/// Métodos que operam no índice de nomes. /////////////////////////////////////
+
+// Hash FNV-1a de 32 bits de uma string.
+static uint32_t hash_nome(const char *str)
+{
+	uint32_t h = 2166136261u;
+
+	for (; *str; ++str)
+		h = (h ^ (uint8_t)*str) * 16777619u;
+
+	return h;
+}
+
+// Indexa pelo nome os `num` Pokémon do catálogo, que deve existir enquanto o
+// índice existir. Se houver nomes repetidos, vale o primeiro.
+void indice_init(IndiceNomes *ind, Pokemon **catalogo, int num)
+{
+	uint32_t tam = 16;
+
+	while (tam < 2 * (uint32_t)num)
+		tam *= 2;
+
+	ind->slots = malloc(tam * sizeof(uint32_t));
+	ind->mascara = tam - 1;
+	ind->catalogo = catalogo;
+
+	// Trata erro na alocação.
+	if (ind->slots == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para o índice de nomes");
+		exit(errsv);
+	}
+	memset(ind->slots, 0xFF, tam * sizeof(uint32_t)); // Tudo VAZIO.
+
+	for (int i = 0; i < num; ++i) {
+		const char *nome = nome_str(&catalogo[i]->name);
+		uint32_t j = hash_nome(nome) & ind->mascara;
+
+		while (ind->slots[j] != VAZIO &&
+		       strcmp(nome_str(&catalogo[ind->slots[j]]->name), nome))
+			j = (j + 1) & ind->mascara;
+
+		if (ind->slots[j] == VAZIO)
+			ind->slots[j] = i;
+	}
+}
+
+void indice_free(IndiceNomes *ind)
+{
+	free(ind->slots);
+	memset(ind, 0, sizeof(*ind));
+}
+
+// Retorna a posição no catálogo do Pokémon chamado `nome`, ou -1.
+int indice_busca(const IndiceNomes *ind, const char *nome)
+{
+	uint32_t j = hash_nome(nome) & ind->mascara;
+
+	for (; ind->slots[j] != VAZIO; j = (j + 1) & ind->mascara) {
+		const Pokemon *p = ind->catalogo[ind->slots[j]];
+
+		if (!strcmp(nome_str(&p->name), nome))
+			return ind->slots[j];
+	}
+
+	return -1;
+}
+
+// Lê o argumento do comando `cmd` em `arg`, que deve ter espaço para TAM_ARG
+// caracteres e o terminador. O argumento vai do primeiro caractere não branco
+// até o fim da linha atual, e não pode faltar: um comando sem argumento não
+// consome a linha seguinte.
+static void ler_arg(char *arg, const char *cmd)
+{
+	int c;
+
+	if (scanf("%*[ \t]%" XSTR(TAM_ARG) "[^\n]", arg) != 1) {
+		fprintf(stderr, "Falta o argumento do comando %s.\n", cmd);
+		exit(EXIT_FAILURE);
+	}
+
+	// O resto da linha deve ter cabido no buffer.
+	if ((c = getchar()) != '\n' && c != EOF) {
+		fprintf(stderr, "O argumento do comando %s é longo demais.\n",
+			cmd);
+		exit(EXIT_FAILURE);
+	}
+}
+
+// Converte o argumento de um comando na posição do Pokémon no catálogo. O
+// argumento é o índice do Pokémon, a partir de 1, ou seu nome.
+static int ler_pokemon(const IndiceNomes *ind, int num, char *arg)
+{
+	char *fim = arg + strlen(arg);
+	long idx;
+
+	// Remove espaços finais, inclusive um '\r' de fim de linha.
+	while (fim > arg && isspace((unsigned char)fim[-1]))
+		*--fim = '\0';
+
+	idx = strtol(arg, &fim, 10);
+	if (fim == arg || *fim != '\0')
+		idx = indice_busca(ind, arg) + 1;
+
+	if (idx < 1 || idx > num) {
+		fprintf(stderr, "Pokémon %s não encontrado.\n", arg);
+		exit(EXIT_FAILURE);
+	}
+
+	return idx - 1;
+}
+
+/// Métodos que operam no índice de bits. //////////////////////////////////////
+
+// Monta os conjuntos de bits dos `num` Pokémon do catálogo. O bit `i` de cada
+// conjunto corresponde ao Pokémon na posição `i` do catálogo.
+void bits_init(IndiceBits *ind, Pokemon **catalogo, int num)
+{
+	ind->palavras = (num + 63) / 64;
+	ind->bits = calloc(NUM_CONJ * ind->palavras, sizeof(uint64_t));
+
+	// Trata erro na alocação.
+	if (ind->bits == NULL && num > 0) {
+		int errsv = errno;
+		perror("Impossível alocar memória para o índice de bits");
+		exit(errsv);
+	}
+
+	for (int i = 0; i < num; ++i) {
+		const Pokemon *p = catalogo[i];
+		uint64_t bit = UINT64_C(1) << (i % 64);
+		int palavra = i / 64;
+
+		bits_conj(ind, CONJ_TODOS)[palavra] |= bit;
+		bits_conj(ind, p->type[0])[palavra] |= bit;
+		if (p->type[1] != NO_TYPE)
+			bits_conj(ind, p->type[1])[palavra] |= bit;
+		if (p->generation <= MAX_GERACAO)
+			bits_conj(ind, CONJ_GERACAO + p->generation)[palavra] |=
+				bit;
+		if (p->is_legendary)
+			bits_conj(ind, CONJ_LENDARIO)[palavra] |= bit;
+	}
+}
+
+void bits_free(IndiceBits *ind)
+{
+	free(ind->bits);
+	memset(ind, 0, sizeof(*ind));
+}
+
+// Retorna o conjunto de número `conj`.
+static inline uint64_t *bits_conj(const IndiceBits *ind, int conj)
+{
+	return ind->bits + (size_t)conj * ind->palavras;
+}
+
+// Conta os bits ligados de um conjunto.
+static int bits_conta(const uint64_t *a, int palavras)
+{
+	int res = 0;
+
+	for (int i = 0; i < palavras; ++i)
+		res += __builtin_popcountll(a[i]);
+
+	return res;
+}
+
+// Printa os nomes dos Pokémon de um conjunto, na ordem do catálogo, visitando
+// só os bits ligados.
+static void imprimir_nomes(Pokemon **catalogo, const uint64_t *a,
+			   int palavras)
+{
+	for (int i = 0; i < palavras; ++i) {
+		for (uint64_t w = a[i]; w; w &= w - 1) {
+			int j = 64 * i + __builtin_ctzll(w);
+			printf(" %s", nome_str(&catalogo[j]->name));
+		}
+	}
+}
+
+// Converte um termo do filtro no número do conjunto correspondente: o nome de
+// um tipo, "genN" para a geração N, ou "lendario". Retorna -1 se não existir.
+static int conj_from_string(const char *str)
+{
+	int ger;
+	char fim;
+
+	if (!strcmp(str, "lendario"))
+		return CONJ_LENDARIO;
+	if (sscanf(str, "gen%d%c", &ger, &fim) == 1 && ger >= 0 &&
+	    ger <= MAX_GERACAO)
+		return CONJ_GERACAO + ger;
+	if (type_from_string(str) != NO_TYPE)
+		return type_from_string(str);
+
+	return -1;
+}
+
+// Funções que avaliam um filtro, por descida recursiva na gramática abaixo.
+// NOT tem precedência sobre AND, que tem precedência sobre OR.
+//
+//	ou  := e { OR e }
+//	e   := nao { AND nao }
+//	nao := NOT nao | termo
+static void filtro_avanca(Filtro *f)
+{
+	f->tok = strtok_r(NULL, " \t\r\n", &f->sav);
+}
+
+static void filtro_ou(const IndiceBits *ind, Filtro *f, uint64_t *res)
+{
+	uint64_t tmp[ind->palavras];
+
+	filtro_e(ind, f, res);
+	while (f->tok && !strcmp(f->tok, "OR")) {
+		filtro_avanca(f);
+		filtro_e(ind, f, tmp);
+		for (int i = 0; i < ind->palavras; ++i)
+			res[i] |= tmp[i];
+	}
+}
+
+static void filtro_e(const IndiceBits *ind, Filtro *f, uint64_t *res)
+{
+	uint64_t tmp[ind->palavras];
+
+	filtro_nao(ind, f, res);
+	while (f->tok && !strcmp(f->tok, "AND")) {
+		filtro_avanca(f);
+		filtro_nao(ind, f, tmp);
+		for (int i = 0; i < ind->palavras; ++i)
+			res[i] &= tmp[i];
+	}
+}
+
+static void filtro_nao(const IndiceBits *ind, Filtro *f, uint64_t *res)
+{
+	const uint64_t *todos = bits_conj(ind, CONJ_TODOS);
+	int conj;
+
+	if (f->tok == NULL) {
+		fputs("Filtro incompleto.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	if (!strcmp(f->tok, "NOT")) {
+		filtro_avanca(f);
+		filtro_nao(ind, f, res);
+		for (int i = 0; i < ind->palavras; ++i)
+			res[i] = ~res[i] & todos[i];
+		return;
+	}
+
+	if ((conj = conj_from_string(f->tok)) < 0) {
+		fprintf(stderr, "Termo %s é inválido no filtro.\n", f->tok);
+		exit(EXIT_FAILURE);
+	}
+	memcpy(res, bits_conj(ind, conj), ind->palavras * sizeof(uint64_t));
+	filtro_avanca(f);
+}
+
+// Avalia o filtro em `str`, que é modificada, e guarda em `res` o conjunto dos
+// Pokémon selecionados.
+void filtrar(const IndiceBits *ind, char *str, uint64_t *res)
+{
+	Filtro f = { .tok = strtok_r(str, " \t\r\n", &f.sav) };
+
+	filtro_ou(ind, &f, res);
+	if (f.tok != NULL) {
+		fprintf(stderr, "Termo %s é inesperado no filtro.\n", f.tok);
+		exit(EXIT_FAILURE);
+	}
+}
+
+// Avalia o filtro em `str` e mostra o resultado do comando `cmd`: C mostra só
+// a contagem, e F também os nomes. O catálogo não pode estar vazio.
+static void mostrar_filtro(const IndiceBits *ind, Pokemon **catalogo,
+			   char cmd, char *str)
+{
+	uint64_t res[ind->palavras]; // Pokémon selecionados.
+
+	filtrar(ind, str, res);
+	printf("(%c) %d", cmd, bits_conta(res, ind->palavras));
+	if (cmd == 'F')
+		imprimir_nomes(catalogo, res, ind->palavras);
+	putchar('\n');
+}
+
 /// Programa principal. ///////////////////////////////////////////////////////
 
 #define NUM_PK 801 // Número máximo de Pokémon no CSV.
@@ -587,10 +1098,13 @@ int main(int argc, char **argv)
 	FILE *csv = fopen((argc > 1) ? argv[1] : DEFAULT_DB, "r");
 	Pokemon *pokemon[NUM_PK] = { NULL }; // Array de Pokémon.
 	ListaPokemon *lista = NULL; // Pokémon selecionados.
+	IndiceNomes nomes; // Índice dos Pokémon por nome.
+	IndiceBits bits; // Índice dos Pokémon por tipo, geração e lendário.
 	int num_lidos = 0; // Número de Pokémon lidos.
 	char *input = NULL; // Buffer para as linhas de entrada.
 	size_t tam_input = 0; // Capacidade do buffer de entrada.
 	char cmd[10]; // Buffer para a leitura dos comandos.
+	char arg[TAM_ARG + 1]; // Buffer para o argumento dos comandos.
 
 	// Verifica se houve erro ao abrir o CSV.
 	if (!csv) {
@@ -607,6 +1121,8 @@ int main(int argc, char **argv)
 	while (num_lidos < NUM_PK && getline(&input, &tam_input, csv) != -1)
 		pokemon[num_lidos++] = pokemon_from_str(input);
 	fclose(csv); // Fecha o arquivo ao terminar.
+	indice_init(&nomes, pokemon, num_lidos);
+	bits_init(&bits, pokemon, num_lidos);
 
 	// Inicializa a lista sequencial verificando erro.
 	if ((lista = malloc(sizeof(*lista))) == NULL) {
@@ -614,16 +1130,18 @@ int main(int argc, char **argv)
 		perror("Impossível alocar memória para a lista");
 		exit(errsv);
 	}
-	lista_init(lista, NUM_PK);
+	lista_init(lista, 0);
 
 	// Lê os índices da entrada padrão e adiciona à lista.
 	while (getline(&input, &tam_input, stdin) != -1 &&
 	       strcmp(input, "FIM\n"))
-		inserir_fim(lista, pokemon_clone(pokemon[atoi(input) - 1]));
+		inserir_fim(lista, atoi(input) - 1);
 	free(input); // Libera o buffer dinâmico de entrada.
 
-	// Lê os comandos de inserção e remoção da lista.
-	while (scanf("%s", cmd) != EOF) {
+	// Lê os comandos de inserção, remoção e busca na lista, e de filtro no
+	// catálogo. Os Pokémon são dados pelo índice no CSV ou pelo nome, que
+	// pode conter espaços e vai até o fim da linha.
+	while (scanf("%9s", cmd) != EOF) {
 		int pos = -1; // Posição para inserir/remover.
 
 		if (cmd[0] == 'I') { // Caso de inserção.
@@ -633,18 +1151,19 @@ int main(int argc, char **argv)
 			if (cmd[1] == '*')
 				scanf("%d", &pos);
 
-			scanf("%d", &idx); // Lê o ID do Pokémon.
-			--idx; // Decrementa para encontrar índice.
+			// Lê o ID ou o nome do Pokémon.
+			ler_arg(arg, cmd);
+			idx = ler_pokemon(&nomes, num_lidos, arg);
 
 			// Determina qual método invocar.
 			if (cmd[1] == 'I')
-				inserir_inicio(lista, pokemon[idx]);
+				inserir_inicio(lista, idx);
 			else if (cmd[1] == '*')
-				inserir(lista, pokemon[idx], pos);
+				inserir(lista, idx, pos);
 			else
-				inserir_fim(lista, pokemon[idx]);
+				inserir_fim(lista, idx);
 		} else if (cmd[0] == 'R') {
-			Pokemon *temp; // Pokémon removido.
+			uint32_t temp; // Índice do Pokémon removido.
 
 			// Lê posição a remover.
 			if (cmd[1] == '*')
@@ -659,20 +1178,41 @@ int main(int argc, char **argv)
 				temp = remover_fim(lista);
 
 			// Mostra o Pokémon removido.
-			printf("(R) %s\n", temp->name);
+			printf("(R) %s\n", nome_str(&pokemon[temp]->name));
+		} else if (cmd[0] == 'P') { // Caso de busca da posição.
+			int idx; // Índice do Pokémon a buscar.
+
+			ler_arg(arg, cmd);
+			idx = ler_pokemon(&nomes, num_lidos, arg);
+
+			// Mostra a posição do Pokémon, ou -1 se não estiver.
+			printf("(P) %s %d\n", nome_str(&pokemon[idx]->name),
+			       lista_busca(lista, idx));
+		} else if (cmd[0] == 'C' || cmd[0] == 'F') { // Caso de filtro.
+			ler_arg(arg, cmd);
+
+			// Mostra quantos Pokémon passam no filtro e, no caso de
+			// F, seus nomes, na ordem do catálogo. Com o catálogo
+			// vazio, os conjuntos não têm palavras, e nenhum passa.
+			if (num_lidos == 0)
+				printf("(%c) 0\n", cmd[0]);
+			else
+				mostrar_filtro(&bits, pokemon, cmd[0], arg);
 		}
 	}
 
-	// Libera o arranjo original.
-	for (int i = 0; i < num_lidos; ++i)
-		pokemon_free(pokemon[i]);
-
-	// Imprime a lista resultante
+	// Imprime a lista resultante, resolvendo os índices no catálogo.
 	for (int i = 0; i < lista->n; ++i) {
 		printf("[%d] ", i);
-		imprimir(lista->arr[i]);
+		imprimir(pokemon[lista->arr[lista_idx(lista, i)]]);
 	}
 
+	// Libera o arranjo original, só depois de resolver todos os índices.
+	indice_free(&nomes);
+	bits_free(&bits);
+	for (int i = 0; i < num_lidos; ++i)
+		pokemon_free(pokemon[i]);
+
 	lista_free(lista); // Libera a lista.
 	return EXIT_SUCCESS;
 }
@@ -2,6 +2,7 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -84,13 +85,16 @@ typedef struct {
 	PokeAbilities abilities; // Lista dinâmica das habilidades.
 } Pokemon;
 
-// Pilha sequencial de Pokémon.
+// Pilha sequencial de Pokémon. Cada elemento é o índice do Pokémon no
+// catálogo, e não um clone: empilhar e desempilhar só movem inteiros.
 typedef struct {
-	Pokemon **arr; // Array de ponteiros.
+	uint32_t *arr; // Array de índices no catálogo.
 	int cap; // Capacidade do array.
 	int n; // Número de elementos logicamente na pilha.
 } PilhaPokemon;
 
+#define CAP_MIN 8 // Capacidade do arranjo ao crescer a partir de vazio.
+
 /// Declarações de todas as funções. //////////////////////////////////////////
 
 // Funções para cumprimento da questão.
@@ -114,9 +118,11 @@ static const char *type_to_string(PokeType type);
 
 // Funções para a implementação da pilha.
 void pilha_init(PilhaPokemon *l, int capacidade);
+void pilha_reserve(PilhaPokemon *l, int capacidade);
+static void pilha_cresce(PilhaPokemon *l);
 void pilha_free(PilhaPokemon *l);
-void push(PilhaPokemon *l, Pokemon *x);
-Pokemon *pop(PilhaPokemon *l);
+void push(PilhaPokemon *l, uint32_t x);
+uint32_t pop(PilhaPokemon *l);
 
 /// Métodos que operam nos Pokémon. ///////////////////////////////////////////
 
@@ -468,71 +474,75 @@ static const char *type_to_string(PokeType type)
 
 /// Métodos que operam na pilha sequencial de Pokémon. ////////////////////////
 
-// Instancia uma pilha de Pokémon.
+// Instancia uma pilha de Pokémon. A capacidade inicial é só uma sugestão: o
+// arranjo cresce sob demanda.
 void pilha_init(PilhaPokemon *l, int capacidade)
 {
-	*l = (PilhaPokemon){ .arr = malloc(sizeof(Pokemon *[capacidade])),
-			     .cap = capacidade,
-			     .n = 0 };
+	*l = (PilhaPokemon){ .arr = NULL, .cap = 0, .n = 0 };
+	pilha_reserve(l, capacidade);
+}
+
+// Garante que o arranjo comporte ao menos `capacidade` elementos sem precisar
+// crescer de novo. Útil antes de inserir muitos elementos de uma vez.
+void pilha_reserve(PilhaPokemon *l, int capacidade)
+{
+	uint32_t *arr;
+
+	if (capacidade <= l->cap)
+		return;
+
+	arr = realloc(l->arr, sizeof(uint32_t[capacidade]));
 
 	// Trata erro na alocação.
-	if (l->arr == NULL) {
+	if (arr == NULL) {
 		int errsv = errno;
 		perror("Impossível alocar memória para array de Pokémon");
 		exit(errsv);
 	}
 
-	memset(l->arr, 0, sizeof(Pokemon *[capacidade]));
+	l->arr = arr;
+	l->cap = capacidade;
 }
 
-// Libera a pilha de Pokémon, e todos os Pokémon contidos.
-void pilha_free(PilhaPokemon *l)
+// Dobra a capacidade do arranjo, garantindo inserção em O(1) amortizado.
+static void pilha_cresce(PilhaPokemon *l)
 {
-	// Libera Pokémon no arranjo.
-	for (int i = 0; i < l->cap; ++i) {
-		Pokemon *ptr = l->arr[i];
-		if (ptr) {
-			pokemon_free(ptr);
-
-			// Para cada ponteiro liberado, é necessário buscar
-			// sequencialmente por quaisquer outros ponteiros
-			// iguais, que podem ter sido duplicados por ordenação
-			// parcial, e fazê-los nulos para evitar double free.
-			for (int j = i; j < l->cap; ++j)
-				if (l->arr[j] == ptr)
-					l->arr[j] = NULL;
-		}
+	if (l->cap > INT_MAX / 2) {
+		fputs("O arranjo da pilha atingiu o tamanho máximo.\n", stderr);
+		exit(EXIT_FAILURE);
 	}
 
+	pilha_reserve(l, l->cap ? 2 * l->cap : CAP_MIN);
+}
+
+// Libera a pilha. Os Pokémon pertencem ao catálogo, e não são liberados.
+void pilha_free(PilhaPokemon *l)
+{
 	// Libera o arranjo e zera os campos do struct.
 	free(l->arr);
 	memset(l, 0, sizeof(*l));
 }
 
-// Função de inserção na pilha. O Pokémon inserido é duplicado.
-void push(PilhaPokemon *l, Pokemon *x)
+// Função de inserção na pilha. Apenas o índice do Pokémon é guardado.
+void push(PilhaPokemon *l, uint32_t x)
 {
-	if (l->n == l->cap) {
-		fputs("O arranjo da pilha está cheio.\n", stderr);
-		exit(EXIT_FAILURE);
-	}
+	if (l->n == l->cap)
+		pilha_cresce(l);
 
 	// Insere o elemento e incrementa `n`.
-	l->arr[l->n++] = pokemon_clone(x);
+	l->arr[l->n++] = x;
 }
 
-// Função de remoção da pilha.
-Pokemon *pop(PilhaPokemon *l)
+// Função de remoção da pilha. Retorna o índice do Pokémon removido.
+uint32_t pop(PilhaPokemon *l)
 {
 	if (l->n == 0) {
 		fputs("A pilha está vazia.\n", stderr);
 		exit(EXIT_FAILURE);
 	}
 
-	Pokemon *res = l->arr[l->n - 1];
-	l->arr[l->n - 1] = NULL; // Limpa o último elemento.
 	l->n -= 1;
-	return res;
+	return l->arr[l->n];
 }
 
 /// Programa principal. ///////////////////////////////////////////////////////
@@ -572,12 +582,12 @@ int main(int argc, char **argv)
 		perror("Impossível alocar memória para a pilha");
 		exit(errsv);
 	}
-	pilha_init(pilha, NUM_PK);
+	pilha_init(pilha, 0);
 
 	// Lê os índices da entrada padrão e adiciona à pilha.
 	while (getline(&input, &tam_input, stdin) != -1 &&
 	       strcmp(input, "FIM\n"))
-		push(pilha, pokemon_clone(pokemon[atoi(input) - 1]));
+		push(pilha, atoi(input) - 1);
 	free(input); // Libera o buffer dinâmico de entrada.
 
 	// Lê os comandos de inserção e remoção da pilha.
@@ -587,23 +597,23 @@ int main(int argc, char **argv)
 			scanf("%d", &idx); // Lê o ID do Pokémon.
 			--idx; // Decrementa para encontrar índice.
 
-			push(pilha, pokemon[idx]);
+			push(pilha, idx);
 		} else if (*cmd == 'R') {
 			// Mostra o Pokémon removido.
-			printf("(R) %s\n", pop(pilha)->name);
+			printf("(R) %s\n", pokemon[pop(pilha)]->name);
 		}
 	}
 
-	// Libera o arranjo original.
-	for (int i = 0; i < num_lidos; ++i)
-		pokemon_free(pokemon[i]);
-
-	// Imprime a pilha resultante
+	// Imprime a pilha resultante, resolvendo os índices no catálogo.
 	for (int i = 0; i < pilha->n; ++i) {
 		printf("[%d] ", i);
-		imprimir(pilha->arr[i]);
+		imprimir(pokemon[pilha->arr[i]]);
 	}
 
+	// Libera o arranjo original, só depois de resolver todos os índices.
+	for (int i = 0; i < num_lidos; ++i)
+		pokemon_free(pokemon[i]);
+
 	// Libera a pilha.
 	pilha_free(pilha);
 	free(pilha);
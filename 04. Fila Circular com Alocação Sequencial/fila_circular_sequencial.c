@@ -8,6 +8,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+// As reduções com AVX2 só são compiladas onde o compilador permite escolher o
+// conjunto de instruções de cada função. A escolha entre elas e a versão
+// escalar é feita em tempo de execução.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TEM_AVX2
+#endif
 
 // De onde ler o CSV se não receber nenhum parâmetro na linha de comando.
 #define DEFAULT_DB "/tmp/pokemon.csv"
@@ -85,17 +94,106 @@ typedef struct {
 	PokeAbilities abilities; // Lista dinâmica das habilidades.
 } Pokemon;
 
-// Fila circular sequencial de Pokémon.
+// Parte de um Pokémon usada com frequência, nas agregações e janelas da fila.
+// Cabe em 12 bytes, e é guardada por valor na fila, que assim não segue
+// ponteiros nem aloca memória a cada inserção.
+typedef struct {
+	Date capture_date; // Data de captura.
+	uint16_t id; // Chave, que indexa a parte fria.
+	uint16_t capture_rate; // Determinante da probabilidade de captura.
+	PokeType type[2]; // Tipos do Pokémon.
+	uint8_t generation; // Geração.
+	bool is_legendary; // Se é ou não um Pokémon lendário.
+} PokemonQuente;
+
+// Parte de um Pokémon usada só para imprimi-lo. As strings pertencem ao
+// Pokémon original.
+typedef struct {
+	double weight; // Peso em quilogramas.
+	double height; // Altura em metros.
+	char *name; // Nome.
+	char *description; // Descrição.
+	PokeAbilities abilities; // Habilidades.
+} PokemonFrio;
+
+// Catálogo com as partes quente e fria de cada Pokémon, em tabelas separadas
+// indexadas pelo id.
+typedef struct {
+	PokemonQuente *quentes; // Partes quentes, indexadas pelo id.
+	PokemonFrio *frios; // Partes frias, indexadas pelo id.
+	uint16_t max_id; // Maior id no catálogo.
+} Catalogo;
+
+// Elemento de um deque monótono: o contador de um elemento na janela e sua
+// taxa de captura.
+typedef struct {
+	uint32_t cont;
+	uint16_t taxa;
+} Extremo;
+
+// Deque circular de `Extremo`, que cresce por duplicação.
+typedef struct {
+	Extremo *arr; // Array de tamanho potência de dois.
+	uint32_t mascara; // Tamanho do array menos um.
+	uint32_t ini, fim; // Contadores do início e do fim.
+} Deque;
+
+// Estatísticas das taxas de captura de uma janela deslizante, mantidas a cada
+// entrada e saída. Os elementos saem na mesma ordem em que entram, o que
+// permite manter o mínimo e o máximo com deques monótonos. Mediana e
+// percentis vêm de uma árvore de Fenwick indexada pela taxa de captura, que
+// tem só 16 bits, e média e variância, das somas das taxas e de seus
+// quadrados.
+#define NUM_TAXAS (UINT16_MAX + 1) // Valores possíveis de `capture_rate`.
+
 typedef struct {
-	Pokemon **arr; // Array de ponteiros.
-	int cap; // Capacidade do array.
-	int primeiro, ultimo; // Índices do primeiro e do último elemento.
+	uint32_t inicio, fim; // Contadores do mais antigo e do próximo.
+	int64_t soma, soma_quad; // Soma das taxas e de seus quadrados.
+	Deque min; // Candidatos a mínimo, em ordem crescente de taxa.
+	Deque max; // Candidatos a máximo, em ordem decrescente de taxa.
+	uint32_t *contagem; // Árvore de Fenwick com a contagem de cada taxa.
+} Estatisticas;
+
+// Janela com os `tam` elementos mais recentes da fila, que mantém seus
+// próprios agregados. Várias janelas compartilham o histórico guardado na
+// fila, que deve ser ao menos tão grande quanto a maior delas.
+typedef struct {
+	uint32_t tam; // Quantidade máxima de elementos na janela.
+	uint32_t inicio; // Contador do elemento mais antigo da janela.
+	int64_t soma_captura; // Soma das taxas de captura na janela.
+	Estatisticas *estat; // Estatísticas da janela, ou NULL.
+} Janela;
+
+// Somas de uma sequência de taxas de captura e de seus quadrados.
+typedef struct {
+	uint64_t soma, soma_quad;
+} Somas;
+
+// Fila circular sequencial de Pokémon. O array tem tamanho potência de dois,
+// e `primeiro` e `ultimo` são contadores que só crescem: a posição no array é
+// obtida por máscara, e a quantidade de elementos é `ultimo - primeiro`, que
+// continua correta mesmo quando os contadores dão a volta. A fila guarda só
+// as partes quentes dos Pokémon, por valor. A taxa de captura de cada posição
+// também fica em uma coluna contígua, para que os agregados possam ser
+// recalculados sem percorrer os registros.
+typedef struct {
+	PokemonQuente *arr; // Array de registros.
+	uint16_t *taxas; // Coluna com a taxa de captura de cada posição.
+	uint32_t mascara; // Tamanho do array menos um.
+	uint32_t capacidade; // Capacidade lógica, a partir da qual há descarte.
+	uint32_t primeiro, ultimo; // Contadores do início e do fim.
+	int32_t dias; // Largura da janela de tempo em dias, ou -1 se não há.
+	int64_t soma_captura; // Soma das taxas de captura dos elementos.
+	Estatisticas *estat; // Estatísticas da fila, ou NULL se desativadas.
+	Janela *janelas; // Janelas sobre a fila, se houver.
+	int num_janelas;
 } FilaPokemon;
 
 /// Declarações de todas as funções. //////////////////////////////////////////
 
 // Funções para cumprimento da questão.
 int main(int argc, char **argv);
+static int ler_janelas(const char *str, uint32_t *tams, uint32_t *max);
 
 // Funções para a implementação do objeto Pokémon.
 void ler(Pokemon *restrict p, char *str);
@@ -112,13 +210,51 @@ void pokemon_free(Pokemon *restrict p);
 static PokeAbilities abilities_from_string(char *str);
 static PokeType type_from_string(const char *str);
 static const char *type_to_string(PokeType type);
+static int32_t date_to_days(Date d);
+
+// Funções para a implementação do catálogo dividido.
+void catalogo_init(Catalogo *c, Pokemon **pokemon, int num);
+void catalogo_free(Catalogo *c);
+static PokemonQuente pokemon_quente(const Pokemon *p);
+static PokemonFrio pokemon_frio(const Pokemon *p);
+void imprimir_dividido(const PokemonQuente *q, const PokemonFrio *f);
 
 // Funções para a implementação da lista.
 void fila_init(FilaPokemon *l, int capacidade);
 void fila_free(FilaPokemon *l);
-void inserir(FilaPokemon *l, Pokemon *x);
-Pokemon *remover(FilaPokemon *l);
+void fila_ativa_estatisticas(FilaPokemon *l);
+void fila_janela_tempo(FilaPokemon *l, int dias);
+void fila_ativa_janelas(FilaPokemon *l, const uint32_t *tams, int num);
+static inline uint32_t fila_idx(const FilaPokemon *l, uint32_t i);
+static void fila_cresce(FilaPokemon *l);
+void inserir(FilaPokemon *l, const PokemonQuente *x);
+PokemonQuente remover(FilaPokemon *l);
 int avg_capture_rate(FilaPokemon *l);
+static void imprimir_media(FilaPokemon *l);
+static void janelas_insere(FilaPokemon *l, uint16_t taxa);
+static void janelas_remove(FilaPokemon *l, uint32_t cont, uint16_t taxa);
+Somas fila_recalcula(const FilaPokemon *l, uint32_t ini, uint32_t fim);
+void fila_verifica(const FilaPokemon *l);
+
+// Funções de redução sobre a coluna de taxas.
+static Somas somar_taxas(const uint16_t *v, uint32_t n);
+static Somas somar_taxas_escalar(const uint16_t *v, uint32_t n);
+#ifdef TEM_AVX2
+static Somas somar_taxas_avx2(const uint16_t *v, uint32_t n);
+#endif
+
+// Funções para as estatísticas da janela.
+static void deque_init(Deque *d);
+static void deque_free(Deque *d);
+static void deque_empurra(Deque *d, Extremo x);
+void estat_init(Estatisticas *e);
+static Estatisticas *estat_new(void);
+void estat_free(Estatisticas *e);
+void estat_insere(Estatisticas *e, uint16_t taxa);
+void estat_remove(Estatisticas *e, uint16_t taxa);
+uint16_t estat_percentil(const Estatisticas *e, int p);
+double estat_desvio(const Estatisticas *e);
+void estat_imprime(const Estatisticas *e);
 
 /// Métodos que operam nos Pokémon. ///////////////////////////////////////////
 
@@ -194,20 +330,10 @@ void ler(Pokemon *restrict p, char *str)
 // Printa um Pokémon recebido por referência em `stdout`.
 void imprimir(Pokemon *restrict const p)
 {
-	printf("[#%d -> %s: %s - ['%s'", p->id, p->name, p->description,
-	       type_to_string(p->type[0]));
+	PokemonQuente q = pokemon_quente(p);
+	PokemonFrio f = pokemon_frio(p);
 
-	if (p->type[1] != NO_TYPE)
-		printf(", '%s'", type_to_string(p->type[1]));
-
-	printf("] - ['%s'", p->abilities.list[0]);
-	for (int i = 1; i < p->abilities.num; ++i)
-		printf(", '%s'", p->abilities.list[i]);
-
-	printf("] - %0.1lfkg - %0.1lfm - %u%% - %s - %u gen] - %02u/%02u/%04u\n",
-	       p->weight, p->height, p->capture_rate,
-	       p->is_legendary ? "true" : "false", p->generation,
-	       p->capture_date.d, p->capture_date.m, p->capture_date.y);
+	imprimir_dividido(&q, &f);
 }
 
 // Aloca um Pokémon a partir de uma string.
@@ -468,55 +594,256 @@ static const char *type_to_string(PokeType type)
 	return res;
 }
 
+// Converte uma data para o número de dias desde 01/01/1970, no calendário
+// gregoriano, de modo que diferenças entre datas sejam subtrações.
+static int32_t date_to_days(Date d)
+{
+	// Conta os anos a partir de março, para que o dia bissexto seja o
+	// último do ano.
+	int32_t y = (int32_t)d.y - (d.m <= 2);
+	int32_t era = (y >= 0 ? y : y - 399) / 400;
+	int32_t yoe = y - era * 400; // Ano da era, em [0, 399].
+	int32_t doy = (153 * (d.m + (d.m > 2 ? -3 : 9)) + 2) / 5 + d.d - 1;
+	int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy; // Dia da era.
+
+	return era * 146097 + doe - 719468;
+}
+
+/// Métodos que operam no catálogo dividido. /////////////////////////////////
+
+// Monta o catálogo a partir dos `num` Pokémon em `pokemon`, que devem existir
+// enquanto o catálogo existir.
+void catalogo_init(Catalogo *c, Pokemon **pokemon, int num)
+{
+	c->max_id = 0;
+	for (int i = 0; i < num; ++i)
+		if (pokemon[i]->id > c->max_id)
+			c->max_id = pokemon[i]->id;
+
+	c->quentes = calloc(c->max_id + 1, sizeof(PokemonQuente));
+	c->frios = calloc(c->max_id + 1, sizeof(PokemonFrio));
+
+	// Trata erro na alocação.
+	if (c->quentes == NULL || c->frios == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para o catálogo");
+		exit(errsv);
+	}
+
+	for (int i = 0; i < num; ++i) {
+		c->quentes[pokemon[i]->id] = pokemon_quente(pokemon[i]);
+		c->frios[pokemon[i]->id] = pokemon_frio(pokemon[i]);
+	}
+}
+
+void catalogo_free(Catalogo *c)
+{
+	free(c->quentes);
+	free(c->frios);
+	memset(c, 0, sizeof(*c));
+}
+
+// Separam as partes quente e fria de um Pokémon.
+static PokemonQuente pokemon_quente(const Pokemon *p)
+{
+	return (PokemonQuente){ .capture_date = p->capture_date,
+				.id = p->id,
+				.capture_rate = p->capture_rate,
+				.type = { p->type[0], p->type[1] },
+				.generation = p->generation,
+				.is_legendary = p->is_legendary };
+}
+
+static PokemonFrio pokemon_frio(const Pokemon *p)
+{
+	return (PokemonFrio){ .weight = p->weight,
+			      .height = p->height,
+			      .name = p->name,
+			      .description = p->description,
+			      .abilities = p->abilities };
+}
+
+// Printa um Pokémon, a partir de suas partes quente e fria, em `stdout`.
+void imprimir_dividido(const PokemonQuente *q, const PokemonFrio *f)
+{
+	printf("[#%d -> %s: %s - ['%s'", q->id, f->name, f->description,
+	       type_to_string(q->type[0]));
+
+	if (q->type[1] != NO_TYPE)
+		printf(", '%s'", type_to_string(q->type[1]));
+
+	printf("] - ['%s'", f->abilities.list[0]);
+	for (int i = 1; i < f->abilities.num; ++i)
+		printf(", '%s'", f->abilities.list[i]);
+
+	printf("] - %0.1lfkg - %0.1lfm - %u%% - %s - %u gen] - %02u/%02u/%04u\n",
+	       f->weight, f->height, q->capture_rate,
+	       q->is_legendary ? "true" : "false", q->generation,
+	       q->capture_date.d, q->capture_date.m, q->capture_date.y);
+}
+
 /// Métodos que operam na lista sequencial de Pokémon. ////////////////////////
 
-// Instancia uma lista de Pokémon.
+// Instancia uma lista de Pokémon. O array é arredondado para a próxima potência
+// de dois, mas a fila descarta elementos ao atingir `capacidade`.
 void fila_init(FilaPokemon *l, int capacidade)
 {
-	*l = (FilaPokemon){ .arr = malloc(sizeof(Pokemon * [capacidade + 1])),
-			    .cap = capacidade + 1,
+	uint32_t tam = 1;
+
+	if (capacidade < 1 || capacidade > (1 << 30)) {
+		fputs("Capacidade inválida para a fila.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	while (tam < (uint32_t)capacidade)
+		tam <<= 1;
+
+	*l = (FilaPokemon){ .arr = calloc(tam, sizeof(PokemonQuente)),
+			    .taxas = calloc(tam, sizeof(uint16_t)),
+			    .mascara = tam - 1,
+			    .capacidade = capacidade,
 			    .primeiro = 0,
-			    .ultimo = 0 };
+			    .ultimo = 0,
+			    .dias = -1,
+			    .soma_captura = 0,
+			    .estat = NULL,
+			    .janelas = NULL,
+			    .num_janelas = 0 };
 
 	// Trata erro na alocação.
-	if (l->arr == NULL) {
+	if (l->arr == NULL || l->taxas == NULL) {
 		int errsv = errno;
 		perror("Impossível alocar memória para array de Pokémon");
 		exit(errsv);
 	}
-
-	// Preenche o arranjo com NULLs.
-	memset(l->arr, 0, sizeof(Pokemon * [capacidade + 1]));
 }
 
-// Libera a lista de Pokémon, e todos os Pokémon contidos.
+// Libera a lista de Pokémon.
 void fila_free(FilaPokemon *l)
 {
-	// Libera Pokémon no arranjo.
-	for (int i = 0; i < l->cap; ++i) {
-		Pokemon *ptr = l->arr[i];
-		if (ptr) {
-			pokemon_free(ptr);
-
-			// Para cada ponteiro liberado, é necessário buscar
-			// sequencialmente por quaisquer outros ponteiros
-			// iguais, que podem ter sido duplicados por ordenação
-			// parcial, e fazê-los nulos para evitar double free.
-			for (int j = i; j < l->cap; ++j)
-				if (l->arr[j] == ptr)
-					l->arr[j] = NULL;
+	// Libera as estatísticas e as janelas, se houver.
+	if (l->estat) {
+		estat_free(l->estat);
+		free(l->estat);
+	}
+	for (int j = 0; j < l->num_janelas; ++j) {
+		if (l->janelas[j].estat) {
+			estat_free(l->janelas[j].estat);
+			free(l->janelas[j].estat);
 		}
 	}
+	free(l->janelas);
+	free(l->taxas);
 
 	// Libera o arranjo e zera os campos do struct.
 	free(l->arr);
 	memset(l, 0, sizeof(*l));
 }
 
+// Passa a manter as estatísticas da janela formada pela fila, e das demais
+// janelas, se houver. A fila deve estar vazia.
+void fila_ativa_estatisticas(FilaPokemon *l)
+{
+	if (l->primeiro != l->ultimo || l->estat) {
+		fputs("As estatísticas devem ser ativadas na fila vazia.\n",
+		      stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	l->estat = estat_new();
+	for (int j = 0; j < l->num_janelas; ++j)
+		l->janelas[j].estat = estat_new();
+}
+
+// Passa a manter, além da fila, uma janela com os últimos `tams[j]` elementos
+// para cada `j`, compartilhando o histórico da fila. A fila deve estar vazia
+// e ser ao menos tão grande quanto a maior janela.
+void fila_ativa_janelas(FilaPokemon *l, const uint32_t *tams, int num)
+{
+	if (l->primeiro != l->ultimo || l->janelas || l->estat || num < 1) {
+		fputs("As janelas devem ser ativadas na fila vazia.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	// Trata erro na alocação.
+	if ((l->janelas = malloc(sizeof(Janela[num]))) == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para as janelas");
+		exit(errsv);
+	}
+
+	for (int j = 0; j < num; ++j) {
+		if (tams[j] < 1 || tams[j] > l->capacidade) {
+			fputs("Janela maior que a fila.\n", stderr);
+			exit(EXIT_FAILURE);
+		}
+
+		l->janelas[j] = (Janela){ .tam = tams[j],
+					  .inicio = l->primeiro,
+					  .soma_captura = 0,
+					  .estat = NULL };
+	}
+	l->num_janelas = num;
+}
+
+// Passa a manter na fila, em vez dos `capacidade` últimos, todos os Pokémon
+// capturados no máximo `dias` dias antes do último inserido. A fila cresce
+// conforme necessário, e os mais antigos saem pelo início, em lotes, conforme
+// a janela avança.
+void fila_janela_tempo(FilaPokemon *l, int dias)
+{
+	if (dias < 0) {
+		fputs("Janela de tempo inválida.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	l->dias = dias;
+	l->capacidade = UINT32_MAX;
+}
+
+// Posição no array do contador `i`.
+static inline uint32_t fila_idx(const FilaPokemon *l, uint32_t i)
+{
+	return i & l->mascara;
+}
+
+// Dobra o tamanho do array. Os contadores não mudam: cada elemento vai para a
+// posição que seu contador indica no novo array.
+static void fila_cresce(FilaPokemon *l)
+{
+	uint32_t tam = 2 * (l->mascara + 1);
+	PokemonQuente *arr = NULL;
+	uint16_t *taxas = NULL;
+
+	if (tam > (UINT32_C(1) << 30)) {
+		fputs("A fila excedeu a capacidade máxima.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	// Trata erro na alocação.
+	if ((arr = calloc(tam, sizeof(PokemonQuente))) == NULL ||
+	    (taxas = calloc(tam, sizeof(uint16_t))) == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para array de Pokémon");
+		exit(errsv);
+	}
+
+	for (uint32_t i = l->primeiro; i != l->ultimo; ++i) {
+		arr[i & (tam - 1)] = l->arr[fila_idx(l, i)];
+		taxas[i & (tam - 1)] = l->taxas[fila_idx(l, i)];
+	}
+
+	free(l->arr);
+	free(l->taxas);
+	l->arr = arr;
+	l->taxas = taxas;
+	l->mascara = tam - 1;
+}
+
 // Métodos auxiliares de teste.
 static bool fila_cheia(FilaPokemon *l)
 {
-	return (l->ultimo + 1) % (l->cap) == l->primeiro;
+	return l->ultimo - l->primeiro == l->capacidade;
 }
 
 static bool fila_vazia(FilaPokemon *l)
@@ -524,84 +851,553 @@ static bool fila_vazia(FilaPokemon *l)
 	return l->primeiro == l->ultimo;
 }
 
-// Funções de inserção na fila. O Pokémon inserido é duplicado.
-void inserir(FilaPokemon *l, Pokemon *x)
+// Funções de inserção na fila. A parte quente do Pokémon é copiada.
+void inserir(FilaPokemon *l, const PokemonQuente *x)
 {
-	if (fila_cheia(l))
-		pokemon_free(remover(l));
+	uint32_t i = 0;
 
-	l->arr[l->ultimo++] = pokemon_clone(x);
-	l->ultimo %= l->cap;
+	if (fila_cheia(l))
+		remover(l);
+	else if (l->ultimo - l->primeiro > l->mascara)
+		fila_cresce(l); // Só acontece na janela de tempo.
+
+	i = fila_idx(l, l->ultimo++);
+	l->arr[i] = *x;
+	l->taxas[i] = x->capture_rate;
+	l->soma_captura += x->capture_rate;
+	if (l->estat)
+		estat_insere(l->estat, x->capture_rate);
+	janelas_insere(l, x->capture_rate);
+
+	// Na janela de tempo, remove do início os Pokémon capturados antes do
+	// começo da janela. O novo Pokémon está sempre dentro dela. O limite é
+	// calculado com 64 bits, já que `dias` pode chegar a INT32_MAX.
+	if (l->dias >= 0) {
+		int64_t limite =
+			(int64_t)date_to_days(x->capture_date) - l->dias;
+
+		while (date_to_days(l->arr[fila_idx(l, l->primeiro)]
+					    .capture_date) < limite)
+			remover(l);
+	}
 }
 
 // Funções de remoção da fila.
-Pokemon *remover(FilaPokemon *l)
+PokemonQuente remover(FilaPokemon *l)
 {
-	Pokemon *resp = NULL;
+	PokemonQuente resp;
 
 	if (fila_vazia(l)) {
 		fputs("A fila já está vazia.\n", stderr);
 		exit(EXIT_FAILURE);
 	}
 
-	resp = l->arr[l->primeiro];
-
-	l->arr[l->primeiro++] = NULL;
-	l->primeiro %= l->cap;
+	resp = l->arr[fila_idx(l, l->primeiro)];
+	janelas_remove(l, l->primeiro++, resp.capture_rate);
+	l->soma_captura -= resp.capture_rate;
+	if (l->estat)
+		estat_remove(l->estat, resp.capture_rate);
 
 	return resp;
 }
 
-// Calcula e retorna a média das taxas de captura na fila.
+// Retorna a média das taxas de captura na fila, em O(1): a soma é mantida
+// por `inserir()` e `remover()`, inclusive quando a fila cheia descarta o
+// elemento mais antigo.
 int avg_capture_rate(FilaPokemon *l)
 {
-	double total = 0;
-	int num = 0;
-
 	if (fila_vazia(l)) {
 		fputs("A fila está vazia.\n", stderr);
 		exit(EXIT_FAILURE);
 	}
 
-	for (int i = l->primeiro; i != l->ultimo; i = (i + 1) % l->cap, ++num)
-		total += l->arr[i]->capture_rate;
+	return (int)round((double)l->soma_captura / (l->ultimo - l->primeiro));
+}
+
+// Mostra a média da fila e, se estiverem ativadas, as demais estatísticas.
+// Se houver janelas, mostra a média de cada uma em vez da média da fila.
+static void imprimir_media(FilaPokemon *l)
+{
+	if (!l->num_janelas) {
+		printf("Média: %d", avg_capture_rate(l));
+		if (l->estat)
+			estat_imprime(l->estat);
+		putchar('\n');
+		return;
+	}
+
+	for (int j = 0; j < l->num_janelas; ++j) {
+		Janela *jan = &l->janelas[j];
+
+		printf("%sMédia %u: %d", j ? " - " : "", jan->tam,
+		       (int)round((double)jan->soma_captura /
+				  (l->ultimo - jan->inicio)));
+		if (jan->estat)
+			estat_imprime(jan->estat);
+	}
+	putchar('\n');
+}
+
+// Adiciona o elemento recém-inserido na fila a cada janela, retirando da
+// janela o seu elemento mais antigo se ela ficar grande demais. Esse elemento
+// ainda está na fila, que é ao menos tão grande quanto a janela.
+static void janelas_insere(FilaPokemon *l, uint16_t taxa)
+{
+	for (int j = 0; j < l->num_janelas; ++j) {
+		Janela *jan = &l->janelas[j];
+
+		jan->soma_captura += taxa;
+		if (jan->estat)
+			estat_insere(jan->estat, taxa);
+
+		if (l->ultimo - jan->inicio > jan->tam) {
+			uint16_t velha = l->arr[fila_idx(l, jan->inicio++)]
+						 .capture_rate;
+
+			jan->soma_captura -= velha;
+			if (jan->estat)
+				estat_remove(jan->estat, velha);
+		}
+	}
+}
+
+// Recalcula, a partir da coluna de taxas, as somas dos elementos de contadores
+// em [`ini`, `fim`), que ocupam no máximo dois trechos contíguos do array.
+Somas fila_recalcula(const FilaPokemon *l, uint32_t ini, uint32_t fim)
+{
+	uint32_t n = fim - ini, pos = fila_idx(l, ini);
+	uint32_t ate_o_fim = l->mascara + 1 - pos; // Posições até o fim.
+	Somas res = somar_taxas(l->taxas + pos, n < ate_o_fim ? n : ate_o_fim);
+
+	// Trecho que deu a volta para o início do array.
+	if (n > ate_o_fim) {
+		Somas resto = somar_taxas(l->taxas, n - ate_o_fim);
+		res.soma += resto.soma;
+		res.soma_quad += resto.soma_quad;
+	}
+
+	return res;
+}
+
+// Confere as somas mantidas pela fila, pelas janelas e pelas estatísticas com
+// as recalculadas, encerrando o programa se alguma divergir.
+void fila_verifica(const FilaPokemon *l)
+{
+	Somas s = fila_recalcula(l, l->primeiro, l->ultimo);
+	bool ok = s.soma == (uint64_t)l->soma_captura &&
+		  (!l->estat || s.soma_quad == (uint64_t)l->estat->soma_quad);
 
-	return (int)round(total / num);
+	for (int j = 0; ok && j < l->num_janelas; ++j) {
+		const Janela *jan = &l->janelas[j];
+
+		s = fila_recalcula(l, jan->inicio, l->ultimo);
+		ok = s.soma == (uint64_t)jan->soma_captura &&
+		     (!jan->estat ||
+		      s.soma_quad == (uint64_t)jan->estat->soma_quad);
+	}
+
+	if (!ok) {
+		fputs("FATAL: somas incrementais divergem das recalculadas!\n",
+		      stderr);
+		exit(EXIT_FAILURE);
+	}
+}
+
+// Retira o elemento de contador `cont`, prestes a sair da fila, das janelas
+// que o contêm: as que começam nele.
+static void janelas_remove(FilaPokemon *l, uint32_t cont, uint16_t taxa)
+{
+	for (int j = 0; j < l->num_janelas; ++j) {
+		Janela *jan = &l->janelas[j];
+
+		if (jan->inicio == cont) {
+			jan->inicio += 1;
+			jan->soma_captura -= taxa;
+			if (jan->estat)
+				estat_remove(jan->estat, taxa);
+		}
+	}
 }
 
 // Função auxiliar de debugging.
 /* static void print_fila(FilaPokemon *l)
 {
 	printf("[ ");
-	for (int i = l->primeiro; i != l->ultimo; i = (i + 1) % l->cap)
-		printf("%s ", l->arr[i]->name);
-	puts("]");
-
-	printf("[ ");
-	for (int i = 0; i < l->cap + 1; ++i)
-		printf("%p ", (void *)l->arr[i]);
+	for (uint32_t i = l->primeiro; i != l->ultimo; ++i)
+		printf("%u ", l->arr[fila_idx(l, i)].id);
 	puts("]");
 
-	printf("Primeiro: %d\tÚltimo: %d\n\n", l->primeiro, l->ultimo);
+	printf("Primeiro: %u\tÚltimo: %u\n\n", l->primeiro, l->ultimo);
 } */
 
+/// Reduções sobre a coluna de taxas. /////////////////////////////////////////
+
+// Soma `n` taxas e seus quadrados, usando AVX2 se o processador tiver.
+static Somas somar_taxas(const uint16_t *v, uint32_t n)
+{
+#ifdef TEM_AVX2
+	static int avx2 = -1; // Se há AVX2, ou -1 se ainda não se sabe.
+
+	if (avx2 < 0)
+		avx2 = __builtin_cpu_supports("avx2") != 0;
+	if (avx2)
+		return somar_taxas_avx2(v, n);
+#endif
+
+	return somar_taxas_escalar(v, n);
+}
+
+static Somas somar_taxas_escalar(const uint16_t *v, uint32_t n)
+{
+	Somas res = { 0, 0 };
+
+	for (uint32_t i = 0; i < n; ++i) {
+		res.soma += v[i];
+		res.soma_quad += (uint64_t)v[i] * v[i];
+	}
+
+	return res;
+}
+
+#ifdef TEM_AVX2
+// Processa 16 taxas por iteração: estende-as para 32 bits em dois vetores de
+// 8, acumula as taxas em somas parciais de 32 bits, esvaziadas em somas de 64
+// bits antes que possam transbordar, e os quadrados diretamente em 64 bits.
+__attribute__((target("avx2"))) static Somas
+somar_taxas_avx2(const uint16_t *v, uint32_t n)
+{
+	// Iterações por lote: cada soma parcial de 32 bits recebe no máximo 2
+	// taxas de 16 bits por iteração.
+	const uint32_t lote = UINT32_C(1) << 14;
+	__m256i soma64 = _mm256_setzero_si256();
+	__m256i quad64 = _mm256_setzero_si256();
+	uint64_t parc[4]; // Somas parciais ao final.
+	Somas res = { 0, 0 }, resto;
+	uint32_t i = 0;
+
+	while (n - i >= 16) {
+		uint32_t iter = (n - i) / 16 < lote ? (n - i) / 16 : lote;
+		__m256i soma32 = _mm256_setzero_si256();
+
+		for (; iter; --iter, i += 16) {
+			__m256i x =
+				_mm256_loadu_si256((const __m256i *)(v + i));
+			__m256i lo = _mm256_cvtepu16_epi32(
+				_mm256_castsi256_si128(x));
+			__m256i hi = _mm256_cvtepu16_epi32(
+				_mm256_extracti128_si256(x, 1));
+
+			soma32 = _mm256_add_epi32(soma32,
+						  _mm256_add_epi32(lo, hi));
+
+			// `_mm256_mul_epu32()` multiplica só as posições pares
+			// de 32 bits; as ímpares são deslocadas antes.
+			quad64 = _mm256_add_epi64(quad64,
+						  _mm256_mul_epu32(lo, lo));
+			quad64 = _mm256_add_epi64(quad64,
+						  _mm256_mul_epu32(hi, hi));
+			lo = _mm256_srli_epi64(lo, 32);
+			hi = _mm256_srli_epi64(hi, 32);
+			quad64 = _mm256_add_epi64(quad64,
+						  _mm256_mul_epu32(lo, lo));
+			quad64 = _mm256_add_epi64(quad64,
+						  _mm256_mul_epu32(hi, hi));
+		}
+
+		soma64 = _mm256_add_epi64(
+			soma64,
+			_mm256_cvtepu32_epi64(_mm256_castsi256_si128(soma32)));
+		soma64 = _mm256_add_epi64(
+			soma64, _mm256_cvtepu32_epi64(
+					_mm256_extracti128_si256(soma32, 1)));
+	}
+
+	_mm256_storeu_si256((__m256i *)parc, soma64);
+	res.soma = parc[0] + parc[1] + parc[2] + parc[3];
+	_mm256_storeu_si256((__m256i *)parc, quad64);
+	res.soma_quad = parc[0] + parc[1] + parc[2] + parc[3];
+
+	// Termina as últimas taxas sem vetorização.
+	resto = somar_taxas_escalar(v + i, n - i);
+	res.soma += resto.soma;
+	res.soma_quad += resto.soma_quad;
+
+	return res;
+}
+#endif
+
+/// Métodos que operam nas estatísticas da janela. //////////////////////////
+
+// Instancia um deque vazio, com espaço para alguns elementos.
+static void deque_init(Deque *d)
+{
+	*d = (Deque){ .arr = malloc(sizeof(Extremo[8])),
+		      .mascara = 7,
+		      .ini = 0,
+		      .fim = 0 };
+
+	// Trata erro na alocação.
+	if (d->arr == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para deque");
+		exit(errsv);
+	}
+}
+
+static void deque_free(Deque *d)
+{
+	free(d->arr);
+	memset(d, 0, sizeof(*d));
+}
+
+// Insere `x` no fim do deque, dobrando o array se estiver cheio.
+static void deque_empurra(Deque *d, Extremo x)
+{
+	if (d->fim - d->ini > d->mascara) {
+		uint32_t tam = 2 * (d->mascara + 1);
+		Extremo *arr = malloc(sizeof(Extremo[tam]));
+
+		// Trata erro na alocação.
+		if (arr == NULL) {
+			int errsv = errno;
+			perror("Impossível alocar memória para deque");
+			exit(errsv);
+		}
+
+		// Copia os elementos para o início do novo array.
+		for (uint32_t i = d->ini; i != d->fim; ++i)
+			arr[i - d->ini] = d->arr[i & d->mascara];
+
+		free(d->arr);
+		*d = (Deque){ .arr = arr,
+			      .mascara = tam - 1,
+			      .ini = 0,
+			      .fim = d->fim - d->ini };
+	}
+
+	d->arr[d->fim++ & d->mascara] = x;
+}
+
+// Instancia estatísticas de uma janela vazia.
+void estat_init(Estatisticas *e)
+{
+	*e = (Estatisticas){ .inicio = 0, .fim = 0, .soma = 0, .soma_quad = 0 };
+	e->contagem = calloc(NUM_TAXAS + 1, sizeof(uint32_t));
+
+	// Trata erro na alocação.
+	if (e->contagem == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para as estatísticas");
+		exit(errsv);
+	}
+
+	deque_init(&e->min);
+	deque_init(&e->max);
+}
+
+// Aloca e instancia estatísticas de uma janela vazia.
+static Estatisticas *estat_new(void)
+{
+	Estatisticas *e = malloc(sizeof(*e));
+
+	// Trata erro na alocação.
+	if (e == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para as estatísticas");
+		exit(errsv);
+	}
+
+	estat_init(e);
+	return e;
+}
+
+void estat_free(Estatisticas *e)
+{
+	deque_free(&e->min);
+	deque_free(&e->max);
+	free(e->contagem);
+	memset(e, 0, sizeof(*e));
+}
+
+// Adiciona uma taxa ao fim da janela, em O(log NUM_TAXAS) mais O(1)
+// amortizado nos deques.
+void estat_insere(Estatisticas *e, uint16_t taxa)
+{
+	Extremo x = { .cont = e->fim++, .taxa = taxa };
+
+	e->soma += taxa;
+	e->soma_quad += (int64_t)taxa * taxa;
+
+	// Elementos mais antigos que não são menores (ou maiores) que o novo
+	// nunca mais serão o mínimo (ou o máximo) da janela.
+	while (e->min.ini != e->min.fim &&
+	       e->min.arr[(e->min.fim - 1) & e->min.mascara].taxa >= taxa)
+		e->min.fim -= 1;
+	deque_empurra(&e->min, x);
+
+	while (e->max.ini != e->max.fim &&
+	       e->max.arr[(e->max.fim - 1) & e->max.mascara].taxa <= taxa)
+		e->max.fim -= 1;
+	deque_empurra(&e->max, x);
+
+	for (uint32_t i = (uint32_t)taxa + 1; i <= NUM_TAXAS; i += i & -i)
+		e->contagem[i] += 1;
+}
+
+// Retira da janela o elemento mais antigo, cuja taxa é `taxa`.
+void estat_remove(Estatisticas *e, uint16_t taxa)
+{
+	uint32_t cont = e->inicio++;
+
+	e->soma -= taxa;
+	e->soma_quad -= (int64_t)taxa * taxa;
+
+	if (e->min.arr[e->min.ini & e->min.mascara].cont == cont)
+		e->min.ini += 1;
+	if (e->max.arr[e->max.ini & e->max.mascara].cont == cont)
+		e->max.ini += 1;
+
+	for (uint32_t i = (uint32_t)taxa + 1; i <= NUM_TAXAS; i += i & -i)
+		e->contagem[i] -= 1;
+}
+
+// Retorna o percentil `p` das taxas na janela, que não pode estar vazia, pelo
+// método do posto mais próximo: a menor taxa que é maior ou igual a `p`% das
+// taxas. Desce a árvore de Fenwick em O(log NUM_TAXAS).
+uint16_t estat_percentil(const Estatisticas *e, int p)
+{
+	uint64_t n = e->fim - e->inicio;
+	uint64_t k = (p * n + 99) / 100; // Posto buscado, a partir de 1.
+	uint32_t pos = 0;
+
+	if (k < 1)
+		k = 1;
+
+	for (uint32_t passo = NUM_TAXAS; passo; passo >>= 1) {
+		if (pos + passo <= NUM_TAXAS && e->contagem[pos + passo] < k) {
+			pos += passo;
+			k -= e->contagem[pos];
+		}
+	}
+
+	// A posição `pos + 1` da árvore corresponde à taxa `pos`.
+	return pos;
+}
+
+// Retorna o desvio padrão populacional das taxas na janela, não vazia.
+double estat_desvio(const Estatisticas *e)
+{
+	double n = e->fim - e->inicio;
+	double var = (e->soma_quad - (double)e->soma * e->soma / n) / n;
+
+	return var > 0 ? sqrt(var) : 0;
+}
+
+// Mostra as estatísticas da janela, não vazia, na linha atual.
+void estat_imprime(const Estatisticas *e)
+{
+	printf(" (mín. %u, máx. %u, mediana %u, p90 %u, desvio padrão %.2lf)",
+	       e->min.arr[e->min.ini & e->min.mascara].taxa,
+	       e->max.arr[e->max.ini & e->max.mascara].taxa,
+	       estat_percentil(e, 50), estat_percentil(e, 90),
+	       estat_desvio(e));
+}
+
 /// Programa principal. ///////////////////////////////////////////////////////
 
 #define NUM_PK 801 // Número máximo de Pokémon no CSV.
 #define CAP_FILA 5 // Capacidade da fila circular.
+#define MAX_JANELAS 16 // Máximo de janelas passadas com `-w`.
+
+// Lê a lista de tamanhos de janela `str`, separados por vírgulas, para
+// `tams`, que comporta `MAX_JANELAS` tamanhos, e o maior deles para `max`.
+// Retorna a quantidade de janelas, ou 0 se a lista for inválida.
+static int ler_janelas(const char *str, uint32_t *tams, uint32_t *max)
+{
+	int num = 0;
+
+	*max = 0;
+	for (;;) {
+		char *fim = NULL;
+		long tam = strtol(str, &fim, 10);
+
+		if (fim == str || tam < 1 || tam > (1 << 30) ||
+		    num == MAX_JANELAS)
+			return 0;
+
+		tams[num++] = tam;
+		if ((uint32_t)tam > *max)
+			*max = tam;
+
+		if (*fim == '\0')
+			return num;
+		if (*fim != ',')
+			return 0;
+		str = fim + 1;
+	}
+}
 
 int main(int argc, char **argv)
 {
-	// Stream do arquivo CSV.
-	FILE *csv = fopen((argc > 1) ? argv[1] : DEFAULT_DB, "r");
+	FILE *csv = NULL; // Stream do arquivo CSV.
 	Pokemon *pokemon[NUM_PK] = { NULL }; // Array de Pokémon.
+	Catalogo catalogo; // Partes quentes e frias dos Pokémon.
 	FilaPokemon *fila = NULL; // Pokémon selecionados.
 	int num_lidos = 0; // Número de Pokémon lidos.
 	char *input = NULL; // Buffer para as linhas de entrada.
 	size_t tam_input = 0; // Capacidade do buffer de entrada.
 	char cmd[10]; // Buffer para a leitura dos comandos.
+	bool estatisticas = false; // Se mostra as estatísticas da janela.
+	bool verifica = false; // Se confere as somas a cada inserção.
+	long dias = -1; // Largura da janela de tempo, ou -1 se não há.
+	uint32_t janelas[MAX_JANELAS]; // Tamanhos das janelas.
+	int num_janelas = 0; // Quantidade de janelas.
+	uint32_t cap = CAP_FILA; // Capacidade da fila, ou da maior janela.
+	char *fim = NULL; // Fim do número lido em uma opção.
+	int opt; // Opção da linha de comando.
+
+	// Lê as opções, que vêm antes do caminho do CSV. Com `-e`, cada média
+	// vem acompanhada das demais estatísticas da janela. Com `-d DIAS`, a
+	// fila guarda os Pokémon capturados até DIAS dias antes do último
+	// inserido, em vez dos `CAP_FILA` últimos. Com `-w T1,T2,...`, mostra
+	// a média dos últimos T1, T2, ... Pokémon, lendo a entrada uma só vez.
+	// Com `-v`, confere a cada inserção as somas mantidas com as somas
+	// recalculadas sobre a janela inteira.
+	while ((opt = getopt(argc, argv, "ed:w:v")) != -1) {
+		bool valida = true; // Se a opção e seu argumento são válidos.
+
+		switch (opt) {
+		case 'e':
+			estatisticas = true;
+			break;
+		case 'v':
+			verifica = true;
+			break;
+		case 'd':
+			dias = strtol(optarg, &fim, 10);
+			valida = *optarg && !*fim && dias >= 0 &&
+				 dias <= INT32_MAX;
+			break;
+		case 'w':
+			// A fila guarda o histórico da maior janela.
+			num_janelas = ler_janelas(optarg, janelas, &cap);
+			valida = num_janelas > 0;
+			break;
+		default:
+			valida = false;
+		}
+
+		if (!valida) {
+			fprintf(stderr,
+				"Uso: %s [-e] [-v] [-d DIAS] [-w T1,T2,...] "
+				"[CSV]\n",
+				argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
 
 	// Verifica se houve erro ao abrir o CSV.
+	csv = fopen((optind < argc) ? argv[optind] : DEFAULT_DB, "r");
 	if (!csv) {
 		int errsv = errno;
 		perror("Falha ao abrir CSV");
@@ -616,6 +1412,7 @@ int main(int argc, char **argv)
 	while (num_lidos < NUM_PK && getline(&input, &tam_input, csv) != -1)
 		pokemon[num_lidos++] = pokemon_from_str(input);
 	fclose(csv); // Fecha o arquivo ao terminar.
+	catalogo_init(&catalogo, pokemon, num_lidos);
 
 	// Inicializa a fila sequencial verificando erro.
 	if ((fila = malloc(sizeof(*fila))) == NULL) {
@@ -623,13 +1420,21 @@ int main(int argc, char **argv)
 		perror("Impossível alocar memória para a fila");
 		exit(errsv);
 	}
-	fila_init(fila, CAP_FILA);
+	fila_init(fila, cap);
+	if (num_janelas)
+		fila_ativa_janelas(fila, janelas, num_janelas);
+	if (dias >= 0)
+		fila_janela_tempo(fila, dias);
+	if (estatisticas)
+		fila_ativa_estatisticas(fila);
 
 	// Lê os índices da entrada padrão e adiciona à fila.
 	while (getline(&input, &tam_input, stdin) != -1 &&
 	       strcmp(input, "FIM\n")) {
-		inserir(fila, pokemon_clone(pokemon[atoi(input) - 1]));
-		printf("Média: %d\n", avg_capture_rate(fila));
+		inserir(fila, &catalogo.quentes[pokemon[atoi(input) - 1]->id]);
+		if (verifica)
+			fila_verifica(fila);
+		imprimir_media(fila);
 	}
 	free(input); // Libera o buffer dinâmico de entrada.
 
@@ -640,29 +1445,33 @@ int main(int argc, char **argv)
 			scanf("%d", &idx); // Lê o ID do Pokémon.
 			--idx; // Decrementa para encontrar índice.
 
-			inserir(fila, pokemon[idx]);
-			printf("Média: %d\n", avg_capture_rate(fila));
+			inserir(fila, &catalogo.quentes[pokemon[idx]->id]);
+			if (verifica)
+				fila_verifica(fila);
+			imprimir_media(fila);
 			// print_fila(fila);
 		} else if (cmd[0] == 'R') {
 			// Mostra o Pokémon removido.
-			Pokemon *ptr = remover(fila);
-			printf("(R) %s\n", ptr->name);
-			pokemon_free(ptr);
+			PokemonQuente x = remover(fila);
+			printf("(R) %s\n", catalogo.frios[x.id].name);
 		}
 	}
 
-	// Libera o arranjo original.
-	for (int i = 0; i < num_lidos; ++i)
-		pokemon_free(pokemon[i]);
-
 	// Imprime a fila resultante
 	putchar('\n'); // Linha de separação.
-	for (int i = fila->primeiro, pos = 0; i != fila->ultimo;
-	     i = (i + 1) % fila->cap, ++pos) {
-		printf("[%d] ", pos);
-		imprimir(fila->arr[i]);
+	for (uint32_t i = fila->primeiro, pos = 0; i != fila->ultimo;
+	     ++i, ++pos) {
+		PokemonQuente *x = &fila->arr[fila_idx(fila, i)];
+
+		printf("[%u] ", pos);
+		imprimir_dividido(x, &catalogo.frios[x->id]);
 	}
 
 	fila_free(fila); // Libera a fila.
+	catalogo_free(&catalogo);
+
+	// Libera o arranjo original, dono das strings do catálogo.
+	for (int i = 0; i < num_lidos; ++i)
+		pokemon_free(pokemon[i]);
 	return EXIT_SUCCESS;
 }
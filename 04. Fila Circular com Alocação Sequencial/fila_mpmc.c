@@ -0,0 +1,1076 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// De onde ler o CSV se não receber nenhum parâmetro na linha de comando.
+#define DEFAULT_DB "/tmp/pokemon.csv"
+
+/// Definições dos tipos de dados. ////////////////////////////////////////////
+
+// Tipos possíveis de Pokémon.
+enum PokeType {
+	NO_TYPE = 0,
+	BUG,
+	DARK,
+	DRAGON,
+	ELECTRIC,
+	FAIRY,
+	FIGHTING,
+	FIRE,
+	FLYING,
+	GHOST,
+	GRASS,
+	GROUND,
+	ICE,
+	NORMAL,
+	POISON,
+	PSYCHIC,
+	ROCK,
+	STEEL,
+	WATER
+};
+
+// Definição do tipo de inteiro que armazena o tipo do Pokémon. Deve ter bits
+// suficientes para todos os tipos.
+typedef uint8_t PokeType;
+
+// Lista de habilidades de um Pokémon.
+typedef struct {
+	char **list; // Lista dinâmica de strings dinâmicas.
+	uint8_t num; // Quantidade de habilidades.
+} PokeAbilities;
+
+// Data.
+typedef struct {
+	uint16_t y; // Ano.
+	uint8_t m; // Mês.
+	uint8_t d; // Dia.
+} Date;
+
+// O Pokémon em si. Usamos tipos numéricos rígidos para economizar memória.
+typedef struct {
+	// Ordenamos os membros de maior (8 bytes) para menor (1 byte) para
+	// melhorar o uso de memória, diminuindo o espaço vazio entre os
+	// membros.
+
+	// Tipos de 64 bits.
+	double weight; // Peso em quilogramas.
+	double height; // Altura em metros.
+
+	// Ponteiros de 32 ou 64 bits, dependendo da máquina.
+	char *name; // String dinâmica para o nome.
+	char *description; // String dinâmica para a descrição.
+
+	// Tipos de 32 bits.
+	Date capture_date; // Data de captura.
+
+	// Tipos de 16 bits.
+	PokeType type[2]; // Tipos do Pokémon.
+	uint16_t id; // Chave: inteiro não-negativo de 16 bits.
+	uint16_t capture_rate; // Determinante da probabilidade de captura.
+
+	// Tipos de 8 bits.
+	uint8_t generation; // Geração: inteiro não-negativo de 8 bits.
+	bool is_legendary; // Se é ou não um Pokémon lendário.
+
+	// Tipo de tamamho irregular (72 bits) no final evita a introdução de
+	// preenchimento no meio da struct.
+	PokeAbilities abilities; // Lista dinâmica das habilidades.
+} Pokemon;
+
+// Fila circular de Pokémon para vários produtores e consumidores, sem travas
+// (fila limitada de Vyukov).
+//
+// Cada posição do array, de tamanho potência de dois, tem um número de
+// sequência que diz de quem é a vez: vale `i` quando a posição está livre para
+// o produtor que obtiver o contador `i`, e `i + 1` quando está ocupada pelo
+// elemento que o consumidor de contador `i` deve retirar. Produtores disputam
+// `ultimo` e consumidores disputam `primeiro` com CAS, mas um produtor e um
+// consumidor só se comunicam pela posição em que se encontram.
+//
+// As variantes que esperam só usam a trava quando a fila está cheia ou vazia
+// há algum tempo: quem espera se registra em `esperando` e dorme em `mudou`,
+// e quem insere ou remove só sinaliza se houver alguém registrado.
+#define LINHA_CACHE 64 // Tamanho de uma linha de cache.
+#define TENTATIVAS 128 // Tentativas antes de dormir nas variantes que esperam.
+
+typedef struct {
+	_Atomic uint32_t seq; // Número de sequência da posição.
+	Pokemon *elemento;
+} Posicao;
+
+typedef struct {
+	// Contadores disputados ficam em linhas de cache separadas.
+	_Alignas(LINHA_CACHE) _Atomic uint32_t ultimo; // Contador do fim.
+	_Alignas(LINHA_CACHE) _Atomic uint32_t primeiro; // Contador do início.
+	_Alignas(LINHA_CACHE) _Atomic int esperando; // Threads dormindo.
+
+	// Campos constantes após `fila_init()`.
+	_Alignas(LINHA_CACHE) Posicao *arr; // Array de posições.
+	uint32_t mascara; // Tamanho do array menos um.
+	uint32_t capacidade; // Capacidade lógica.
+	pthread_mutex_t trava; // Protege só a espera em `mudou`.
+	pthread_cond_t mudou; // Sinalizada quando a fila muda com `esperando`.
+} FilaPokemon;
+
+// Fila circular sequencial protegida por uma trava global, usada só como
+// referência no teste de desempenho.
+typedef struct {
+	pthread_mutex_t trava;
+	pthread_cond_t nao_cheia, nao_vazia; // Sinalizadas a cada mudança.
+	Pokemon **arr; // Array de ponteiros.
+	uint32_t mascara; // Tamanho do array menos um.
+	uint32_t primeiro, ultimo; // Contadores do início e do fim.
+} FilaTravada;
+
+// Estado compartilhado por uma rodada do teste de estresse.
+typedef struct {
+	void *fila; // Fila sob teste.
+	void (*insere)(void *fila, Pokemon *x); // Espera se estiver cheia.
+	Pokemon *(*remove)(void *fila); // Espera se estiver vazia.
+	Pokemon **catalogo; // Pokémon inseridos pelos produtores.
+	int num_catalogo;
+	long por_produtor; // Pokémon inseridos por cada produtor.
+	_Atomic long consumidos; // Pokémon removidos.
+	_Atomic long soma_ids; // Soma dos ids dos Pokémon removidos.
+} Rodada;
+
+// Argumento de cada thread de uma rodada.
+typedef struct {
+	Rodada *rodada;
+	int id; // Número da thread na rodada.
+	long num; // Pokémon que a thread deve inserir ou remover.
+} Tarefa;
+
+/// Declarações de todas as funções. //////////////////////////////////////////
+
+// Funções para cumprimento da questão.
+int main(int argc, char **argv);
+
+// Funções para a implementação do objeto Pokémon.
+void ler(Pokemon *restrict p, char *str);
+void imprimir(Pokemon *restrict const p);
+Pokemon *pokemon_from_str(char *str);
+Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
+			     const char *description, const PokeType type[2],
+			     const PokeAbilities *abilities, double weight_kg,
+			     double height_m, uint16_t capture_rate,
+			     bool is_legendary, Date capture_date);
+Pokemon *pokemon_clone(const Pokemon *p);
+static inline Pokemon *pokemon_new(void);
+void pokemon_free(Pokemon *restrict p);
+static PokeAbilities abilities_from_string(char *str);
+static PokeType type_from_string(const char *str);
+static const char *type_to_string(PokeType type);
+
+// Funções para a implementação da fila.
+void fila_init(FilaPokemon *l, int capacidade);
+void fila_free(FilaPokemon *l);
+static inline Posicao *fila_pos(const FilaPokemon *l, uint32_t i);
+static void fila_acorda(FilaPokemon *l);
+static void fila_espera(FilaPokemon *l, bool (*pronta)(FilaPokemon *l));
+bool tentar_inserir(FilaPokemon *l, Pokemon *x);
+Pokemon *tentar_remover(FilaPokemon *l);
+static bool fila_nao_cheia(FilaPokemon *l);
+static bool fila_nao_vazia(FilaPokemon *l);
+void inserir_esperando(FilaPokemon *l, Pokemon *x);
+Pokemon *remover_esperando(FilaPokemon *l);
+void inserir(FilaPokemon *l, Pokemon *x);
+Pokemon *remover(FilaPokemon *l);
+int avg_capture_rate(FilaPokemon *l);
+
+// Funções para o teste de estresse e de desempenho.
+static void travada_insere(void *p, Pokemon *x);
+static Pokemon *travada_remove(void *p);
+static void livre_insere(void *p, Pokemon *x);
+static Pokemon *livre_remove(void *p);
+static void *produtor(void *arg);
+static void *consumidor(void *arg);
+static bool rodada(const char *nome, Rodada *r, int num_threads);
+static int estresse(Pokemon **catalogo, int num_catalogo, int max_threads,
+		    long por_produtor, int capacidade);
+
+/// Métodos que operam nos Pokémon. ///////////////////////////////////////////
+
+// Lê um Pokémon a partir de uma string. A string é modificada.
+void ler(Pokemon *restrict p, char *str)
+{
+	// Posição inicial dos termos após a lista de habilidades. Necessária
+	// porque o método `abilities_from_string()` invalidará a string `str`
+	// antes dessa posição.
+	char *const post_list = strstr(str, "']\",") + 3;
+	char *tok = NULL; // Ponteiro temporário para as substrings (tokens).
+	char *sav = NULL; // Ponteiro auxiliar para o estado de `strtok_r()`.
+	int tok_count = 0; // Contador auxiliar de tokens.
+
+	// Verifica erro ao buscar a substring.
+	if (!post_list) {
+		int errsv = errno;
+		perror("Tentei criar Pokémon com uma string mal formada");
+		exit(errsv);
+	}
+
+	// Lê a chave (id) e a geração.
+	p->id = atoi(strtok_r(str, ",", &sav));
+	p->generation = atoi(strtok_r(NULL, ",", &sav));
+
+	// Lê o nome.
+	tok = strtok_r(NULL, ",", &sav);
+	p->name = strdup(tok);
+
+	// Lê a descrição.
+	tok = strtok_r(NULL, ",", &sav);
+	p->description = strdup(tok);
+
+	// Lê o primeiro tipo.
+	p->type[0] = type_from_string(strtok_r(NULL, ",", &sav));
+
+	// Lẽ o segundo tipo, se existir.
+	tok = strtok_r(NULL, "[,", &sav);
+	p->type[1] = (*tok == '"') ? NO_TYPE : type_from_string(tok);
+
+	// Lê a lista de habilidades.
+	p->abilities = abilities_from_string(strtok_r(NULL, "]", &sav));
+	str = post_list; // Avança para após a lista de habilidades.
+	sav = NULL; // Reseta o ponteiro de `strtok_r()`.
+
+	// Leia peso e altura, se existirem (alguns Pokémon no CSV não têm, mas
+	// todos que têm peso também têm altura, e vice-versa). Por isso,
+	// determina quantos campos não vazios restam.
+	for (int i = 0; str[i]; ++i)
+		// Vírgulas não-consecutivas indicam campo não vazio.
+		if (str[i] == ',' && str[i + 1] != ',')
+			++tok_count;
+
+	// Leia peso e altura, se existirem (alguns Pokémon no CSV não têm, mas
+	// todos que têm peso também têm altura, e vice-versa).
+	if (tok_count == 5) { // Se restam 5 itens, o peso e a altura existem.
+		p->weight = atof(strtok_r(str, ",", &sav));
+		p->height = atof(strtok_r(NULL, ",", &sav));
+	} else {
+		p->height = p->weight = 0; // Atribui um peso inválido.
+	}
+
+	// Lê o determinante da probabilidade de captura e se é lendário ou não.
+	p->capture_rate = atoi(strtok_r(sav ? NULL : str, ",", &sav));
+	p->is_legendary = atoi(strtok_r(NULL, ",", &sav));
+
+	// Lê a data de captura.
+	p->capture_date.d = atoi(strtok_r(NULL, "/", &sav));
+	p->capture_date.m = atoi(strtok_r(NULL, "/", &sav));
+	p->capture_date.y = atoi(strtok_r(NULL, "/\n\r", &sav));
+}
+
+// Printa um Pokémon recebido por referência em `stdout`.
+void imprimir(Pokemon *restrict const p)
+{
+	printf("[#%d -> %s: %s - ['%s'", p->id, p->name, p->description,
+	       type_to_string(p->type[0]));
+
+	if (p->type[1] != NO_TYPE)
+		printf(", '%s'", type_to_string(p->type[1]));
+
+	printf("] - ['%s'", p->abilities.list[0]);
+	for (int i = 1; i < p->abilities.num; ++i)
+		printf(", '%s'", p->abilities.list[i]);
+
+	printf("] - %0.1lfkg - %0.1lfm - %u%% - %s - %u gen] - %02u/%02u/%04u\n",
+	       p->weight, p->height, p->capture_rate,
+	       p->is_legendary ? "true" : "false", p->generation,
+	       p->capture_date.d, p->capture_date.m, p->capture_date.y);
+}
+
+// Aloca um Pokémon a partir de uma string.
+Pokemon *pokemon_from_str(char *str)
+{
+	Pokemon *res = pokemon_new();
+	ler(res, str);
+	return res;
+}
+
+// Aloca um Pokémon a partir de parâmetros.
+Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
+			     const char *description, const PokeType type[2],
+			     const PokeAbilities *abilities, double weight_kg,
+			     double height_m, uint16_t capture_rate,
+			     bool is_legendary, Date capture_date)
+{
+	Pokemon *res = pokemon_new();
+
+	// Precisamos criar uma cópia profunda da lista de habilidades.
+	PokeAbilities ablist_clone = { .num = abilities->num };
+	ablist_clone.list = malloc(ablist_clone.num * sizeof(char *));
+	for (int i = 0; i < ablist_clone.num; ++i)
+		ablist_clone.list[i] = strdup(abilities->list[i]);
+
+	*res = (Pokemon){ .id = id,
+			  .generation = generation,
+			  .name = strdup(name),
+			  .description = strdup(description),
+			  .type[0] = type[0],
+			  .type[1] = type[1],
+			  .abilities = ablist_clone,
+			  .weight = weight_kg,
+			  .height = height_m,
+			  .capture_rate = capture_rate,
+			  .is_legendary = is_legendary,
+			  .capture_date = capture_date };
+	return res;
+}
+
+// Duplica um Pokemón.
+Pokemon *pokemon_clone(const Pokemon *p)
+{
+	return pokemon_from_params(p->id, p->generation, p->name,
+				   p->description, p->type, &p->abilities,
+				   p->weight, p->height, p->capture_rate,
+				   p->is_legendary, p->capture_date);
+}
+
+// Aloca um Pokémon vazio dinamicamente.
+static inline Pokemon *pokemon_new(void)
+{
+	Pokemon *res = calloc(1, sizeof(Pokemon));
+	if (!res) {
+		int errsv = errno;
+		perror("Impossível alocar memória para Pokémon");
+		exit(errsv);
+	}
+	return res;
+}
+
+// Libera um Pokémon alocado dinamicamente.
+void pokemon_free(Pokemon *restrict p)
+{
+	if (p != NULL) {
+		free(p->name);
+		free(p->description);
+		for (int i = 0; i < p->abilities.num; ++i)
+			free(p->abilities.list[i]);
+		free(p->abilities.list);
+		free(p);
+	}
+}
+
+// Cria uma lista dinâmica de habilidades a partir de uma representação textual.
+static PokeAbilities abilities_from_string(char *str)
+{
+	PokeAbilities res = { .num = 1 }; // Há no mínimo uma habilidade.
+	char *sav = NULL;
+
+	// Conta o número de habilidades a partir das vírgulas na string.
+	for (int i = 0; str[i] && str[i] != ']'; ++i)
+		if (str[i] == ',')
+			++res.num;
+	// Aloca memória para a lista dinâmica.
+	res.list = malloc(res.num * sizeof(char *));
+	if (!res.list) {
+		int errsv = errno;
+		perror("Impossível alocar memória para lista de habilidades");
+		exit(errsv);
+	}
+
+	// Lê cada uma das habilidades.
+	for (int i = 0; i < res.num; ++i) {
+		char *ability; // Ponteiro temporário para a substring (token).
+		int token_len = 0; // Contador to tamanho do token `ability`.
+
+		// Extrai um token da lista.
+		ability = strtok_r(i ? NULL : str, ",]", &sav);
+		if (!ability) {
+			int errsv = errno;
+			for (int j = 0; j < i; ++j) {
+				free(res.list[j]);
+			}
+			free(res.list);
+			res.list = NULL;
+			res.num = 0;
+			perror("Erro ao extrair habilidade da string");
+			exit(errsv);
+		}
+
+		// Remove quaisquer caracteres exceto letras, números e espaços.
+		for (int j = 0; ability[j]; ++j)
+			if (isalnum(ability[j]) || isspace(ability[j]))
+				ability[token_len++] = ability[j];
+		ability[token_len] = '\0'; // Termina o token.
+
+		// Remove espaços e aspas iniciais.
+		while (*ability == ' ' || *ability == '\'') {
+			++ability;
+			--token_len;
+		}
+
+		// Remove espaços e aspas finais.
+		while (token_len > 0 && (ability[token_len - 1] == ' ' ||
+					 ability[token_len - 1] == '\''))
+			ability[--token_len] = '\0';
+
+		// Aloca a memória para a habilidade e a salva no struct.
+		res.list[i] = strdup(ability);
+		if (!res.list[i]) {
+			int errsv = errno;
+			for (int j = 0; j < i; ++j) {
+				free(res.list[j]);
+			}
+			free(res.list);
+			res.list = NULL;
+			res.num = 0;
+			perror("Impossível alocar memória para habilidade");
+			exit(errsv);
+		}
+	}
+
+	return res;
+}
+
+// Converte a representação textual do tipo em um dado PokeType.
+static PokeType type_from_string(const char *str)
+{
+	enum PokeType res;
+
+	if (!strcmp(str, "bug"))
+		res = BUG;
+	else if (!strcmp(str, "dark"))
+		res = DARK;
+	else if (!strcmp(str, "dragon"))
+		res = DRAGON;
+	else if (!strcmp(str, "electric"))
+		res = ELECTRIC;
+	else if (!strcmp(str, "fairy"))
+		res = FAIRY;
+	else if (!strcmp(str, "fighting"))
+		res = FIGHTING;
+	else if (!strcmp(str, "fire"))
+		res = FIRE;
+	else if (!strcmp(str, "flying"))
+		res = FLYING;
+	else if (!strcmp(str, "ghost"))
+		res = GHOST;
+	else if (!strcmp(str, "grass"))
+		res = GRASS;
+	else if (!strcmp(str, "ground"))
+		res = GROUND;
+	else if (!strcmp(str, "ice"))
+		res = ICE;
+	else if (!strcmp(str, "normal"))
+		res = NORMAL;
+	else if (!strcmp(str, "poison"))
+		res = POISON;
+	else if (!strcmp(str, "psychic"))
+		res = PSYCHIC;
+	else if (!strcmp(str, "rock"))
+		res = ROCK;
+	else if (!strcmp(str, "steel"))
+		res = STEEL;
+	else if (!strcmp(str, "water"))
+		res = WATER;
+	else
+		res = NO_TYPE;
+
+	return res;
+}
+
+// Converte um dado PokeType em sua representação textual.
+static const char *type_to_string(PokeType type)
+{
+	const char *res = NULL;
+	switch (type) {
+	case BUG:
+		res = "bug";
+		break;
+	case DARK:
+		res = "dark";
+		break;
+	case DRAGON:
+		res = "dragon";
+		break;
+	case ELECTRIC:
+		res = "electric";
+		break;
+	case FAIRY:
+		res = "fairy";
+		break;
+	case FIGHTING:
+		res = "fighting";
+		break;
+	case FIRE:
+		res = "fire";
+		break;
+	case FLYING:
+		res = "flying";
+		break;
+	case GHOST:
+		res = "ghost";
+		break;
+	case GRASS:
+		res = "grass";
+		break;
+	case GROUND:
+		res = "ground";
+		break;
+	case ICE:
+		res = "ice";
+		break;
+	case NORMAL:
+		res = "normal";
+		break;
+	case POISON:
+		res = "poison";
+		break;
+	case PSYCHIC:
+		res = "psychic";
+		break;
+	case ROCK:
+		res = "rock";
+		break;
+	case STEEL:
+		res = "steel";
+		break;
+	case WATER:
+		res = "water";
+		break;
+	default:
+		fputs("FATAL: Pokémon tem um tipo desconhecido!\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return res;
+}
+
+/// Métodos que operam na fila MPMC de Pokémon. ///////////////////////////////
+
+// Instancia uma fila de Pokémon. O array é arredondado para a próxima potência
+// de dois, e tem ao menos duas posições, para que os números de sequência de
+// uma posição livre e ocupada não coincidam. Com mais de uma thread, a
+// capacidade lógica é respeitada de forma aproximada, mas nunca passa do
+// tamanho do array.
+void fila_init(FilaPokemon *l, int capacidade)
+{
+	uint32_t tam = 2;
+
+	if (capacidade < 1 || capacidade > (1 << 30)) {
+		fputs("Capacidade inválida para a fila.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	while (tam < (uint32_t)capacidade)
+		tam <<= 1;
+
+	memset(l, 0, sizeof(*l));
+	l->arr = malloc(sizeof(Posicao[tam]));
+	l->mascara = tam - 1;
+	l->capacidade = capacidade;
+
+	// Trata erro na alocação.
+	if (l->arr == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para array de Pokémon");
+		exit(errsv);
+	}
+
+	// Cada posição começa livre para o produtor de mesmo contador.
+	for (uint32_t i = 0; i < tam; ++i) {
+		atomic_init(&l->arr[i].seq, i);
+		l->arr[i].elemento = NULL;
+	}
+	atomic_init(&l->ultimo, 0);
+	atomic_init(&l->primeiro, 0);
+	atomic_init(&l->esperando, 0);
+	pthread_mutex_init(&l->trava, NULL);
+	pthread_cond_init(&l->mudou, NULL);
+}
+
+// Libera a fila de Pokémon, e todos os Pokémon contidos. Nenhuma outra thread
+// pode estar usando a fila.
+void fila_free(FilaPokemon *l)
+{
+	uint32_t fim = atomic_load(&l->ultimo);
+
+	for (uint32_t i = atomic_load(&l->primeiro); i != fim; ++i)
+		pokemon_free(fila_pos(l, i)->elemento);
+
+	// Libera o arranjo e zera os campos do struct.
+	pthread_cond_destroy(&l->mudou);
+	pthread_mutex_destroy(&l->trava);
+	free(l->arr);
+	memset(l, 0, sizeof(*l));
+}
+
+// Posição do array correspondente ao contador `i`.
+static inline Posicao *fila_pos(const FilaPokemon *l, uint32_t i)
+{
+	return &l->arr[i & l->mascara];
+}
+
+// Acorda as threads que esperam uma mudança na fila, se houver alguma. A
+// barreira garante que, se a leitura de `esperando` não vir uma thread que
+// acabou de se registrar, essa thread verá a mudança antes de dormir.
+static void fila_acorda(FilaPokemon *l)
+{
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(&l->esperando, memory_order_relaxed)) {
+		pthread_mutex_lock(&l->trava);
+		pthread_cond_broadcast(&l->mudou);
+		pthread_mutex_unlock(&l->trava);
+	}
+}
+
+// Dorme até que `pronta` indique que a próxima operação deve ter sucesso.
+static void fila_espera(FilaPokemon *l, bool (*pronta)(FilaPokemon *l))
+{
+	atomic_fetch_add(&l->esperando, 1);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	pthread_mutex_lock(&l->trava);
+	while (!pronta(l))
+		pthread_cond_wait(&l->mudou, &l->trava);
+	pthread_mutex_unlock(&l->trava);
+
+	atomic_fetch_sub(&l->esperando, 1);
+}
+
+// Insere `x` no fim da fila, sem duplicá-lo. Retorna false, sem inserir, se a
+// fila estiver cheia.
+bool tentar_inserir(FilaPokemon *l, Pokemon *x)
+{
+	uint32_t u = atomic_load_explicit(&l->ultimo, memory_order_relaxed);
+
+	for (;;) {
+		Posicao *p = fila_pos(l, u);
+		uint32_t seq = atomic_load_explicit(&p->seq,
+						    memory_order_acquire);
+		int32_t dif = (int32_t)(seq - u);
+
+		if (dif < 0) // A posição ainda não foi liberada: fila cheia.
+			return false;
+
+		if (dif > 0) { // Outro produtor já pegou `u`.
+			u = atomic_load_explicit(&l->ultimo,
+						 memory_order_relaxed);
+			continue;
+		}
+
+		// Se a capacidade lógica for menor que o array, confere-a
+		// também. O contador `primeiro` lido pode estar atrasado, o que
+		// só faz a fila parecer mais cheia.
+		if (l->capacidade <= l->mascara &&
+		    (int32_t)(u - atomic_load_explicit(&l->primeiro,
+						       memory_order_relaxed)) >=
+			    (int32_t)l->capacidade)
+			return false;
+
+		if (atomic_compare_exchange_weak_explicit(
+			    &l->ultimo, &u, u + 1, memory_order_relaxed,
+			    memory_order_relaxed)) {
+			p->elemento = x;
+			atomic_store_explicit(&p->seq, u + 1,
+					      memory_order_release);
+			fila_acorda(l);
+			return true;
+		}
+	}
+}
+
+// Remove e retorna o primeiro elemento da fila, ou NULL se ela estiver vazia.
+Pokemon *tentar_remover(FilaPokemon *l)
+{
+	uint32_t c = atomic_load_explicit(&l->primeiro, memory_order_relaxed);
+
+	for (;;) {
+		Posicao *p = fila_pos(l, c);
+		uint32_t seq = atomic_load_explicit(&p->seq,
+						    memory_order_acquire);
+		int32_t dif = (int32_t)(seq - (c + 1));
+
+		if (dif < 0) // A posição ainda não foi preenchida: fila vazia.
+			return NULL;
+
+		if (dif > 0) { // Outro consumidor já pegou `c`.
+			c = atomic_load_explicit(&l->primeiro,
+						 memory_order_relaxed);
+			continue;
+		}
+
+		if (atomic_compare_exchange_weak_explicit(
+			    &l->primeiro, &c, c + 1, memory_order_relaxed,
+			    memory_order_relaxed)) {
+			Pokemon *x = p->elemento;
+
+			// Libera a posição para o produtor da próxima volta.
+			atomic_store_explicit(&p->seq, c + l->mascara + 1,
+					      memory_order_release);
+			fila_acorda(l);
+			return x;
+		}
+	}
+}
+
+// Predicados usados pelas variantes que esperam: se a próxima inserção ou
+// remoção deve ter sucesso, caso nenhuma outra thread chegue antes.
+static bool fila_nao_cheia(FilaPokemon *l)
+{
+	uint32_t u = atomic_load(&l->ultimo);
+
+	return atomic_load(&fila_pos(l, u)->seq) == u &&
+	       (int32_t)(u - atomic_load(&l->primeiro)) <
+		       (int32_t)l->capacidade;
+}
+
+static bool fila_nao_vazia(FilaPokemon *l)
+{
+	uint32_t c = atomic_load(&l->primeiro);
+
+	return atomic_load(&fila_pos(l, c)->seq) == c + 1;
+}
+
+// Insere `x` no fim da fila, sem duplicá-lo, esperando se ela estiver cheia.
+void inserir_esperando(FilaPokemon *l, Pokemon *x)
+{
+	for (int i = 0; !tentar_inserir(l, x); ++i)
+		if (i >= TENTATIVAS)
+			fila_espera(l, fila_nao_cheia);
+}
+
+// Remove e retorna o primeiro elemento da fila, esperando se ela estiver
+// vazia.
+Pokemon *remover_esperando(FilaPokemon *l)
+{
+	Pokemon *x = NULL;
+
+	for (int i = 0; !(x = tentar_remover(l)); ++i)
+		if (i >= TENTATIVAS)
+			fila_espera(l, fila_nao_vazia);
+
+	return x;
+}
+
+// Funções de inserção na fila, com a semântica da fila sequencial: o Pokémon
+// inserido é duplicado e, se a fila estiver cheia, o mais antigo é liberado.
+void inserir(FilaPokemon *l, Pokemon *x)
+{
+	Pokemon *novo = pokemon_clone(x);
+
+	while (!tentar_inserir(l, novo))
+		pokemon_free(tentar_remover(l));
+}
+
+// Funções de remoção da fila.
+Pokemon *remover(FilaPokemon *l)
+{
+	Pokemon *resp = tentar_remover(l);
+
+	if (!resp) {
+		fputs("A fila já está vazia.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return resp;
+}
+
+// Calcula e retorna a média das taxas de captura na fila. Nenhuma outra thread
+// pode estar usando a fila. Ao contrário da fila sequencial, não mantém uma
+// soma, que seria um contador disputado por todas as threads.
+int avg_capture_rate(FilaPokemon *l)
+{
+	uint32_t fim = atomic_load(&l->ultimo);
+	uint32_t ini = atomic_load(&l->primeiro);
+	int64_t soma = 0;
+
+	if (ini == fim) {
+		fputs("A fila está vazia.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint32_t i = ini; i != fim; ++i)
+		soma += fila_pos(l, i)->elemento->capture_rate;
+
+	return (int)round((double)soma / (fim - ini));
+}
+
+/// Teste de estresse e de desempenho. ////////////////////////////////////////
+
+// Insere na fila travada, esperando se ela estiver cheia.
+static void travada_insere(void *p, Pokemon *x)
+{
+	FilaTravada *l = p;
+
+	pthread_mutex_lock(&l->trava);
+	while (l->ultimo - l->primeiro > l->mascara)
+		pthread_cond_wait(&l->nao_cheia, &l->trava);
+	l->arr[l->ultimo++ & l->mascara] = x;
+	pthread_cond_signal(&l->nao_vazia);
+	pthread_mutex_unlock(&l->trava);
+}
+
+// Remove da fila travada, esperando se ela estiver vazia.
+static Pokemon *travada_remove(void *p)
+{
+	FilaTravada *l = p;
+	Pokemon *res = NULL;
+
+	pthread_mutex_lock(&l->trava);
+	while (l->ultimo == l->primeiro)
+		pthread_cond_wait(&l->nao_vazia, &l->trava);
+	res = l->arr[l->primeiro++ & l->mascara];
+	pthread_cond_signal(&l->nao_cheia);
+	pthread_mutex_unlock(&l->trava);
+
+	return res;
+}
+
+// Adaptadores da fila sem travas para a interface das rodadas.
+static void livre_insere(void *p, Pokemon *x)
+{
+	inserir_esperando(p, x);
+}
+
+static Pokemon *livre_remove(void *p)
+{
+	return remover_esperando(p);
+}
+
+// Produtor: insere `num` Pokémon do catálogo.
+static void *produtor(void *arg)
+{
+	Tarefa *t = arg;
+	Rodada *r = t->rodada;
+
+	for (long j = 0; j < t->num; ++j)
+		r->insere(r->fila, r->catalogo[(t->id * t->num + j) %
+					       r->num_catalogo]);
+
+	return NULL;
+}
+
+// Consumidor: remove `num` Pokémon, somando seus ids.
+static void *consumidor(void *arg)
+{
+	Tarefa *t = arg;
+	Rodada *r = t->rodada;
+	long soma = 0;
+
+	for (long j = 0; j < t->num; ++j)
+		soma += r->remove(r->fila)->id;
+
+	atomic_fetch_add(&r->consumidos, t->num);
+	atomic_fetch_add(&r->soma_ids, soma);
+	return NULL;
+}
+
+// Executa uma rodada com `num_threads` produtores e outros tantos
+// consumidores, verifica que cada Pokémon inserido foi removido exatamente uma
+// vez, e mostra a vazão. Retorna se a verificação teve sucesso.
+static bool rodada(const char *nome, Rodada *r, int num_threads)
+{
+	pthread_t threads[2 * num_threads];
+	Tarefa tarefas[2 * num_threads];
+	struct timespec ini, fim;
+	long esperados = (long)num_threads * r->por_produtor, soma = 0;
+	double seg;
+
+	// Calcula a soma dos ids que os produtores vão inserir.
+	for (long j = 0; j < esperados; ++j)
+		soma += r->catalogo[j % r->num_catalogo]->id;
+
+	atomic_store(&r->consumidos, 0);
+	atomic_store(&r->soma_ids, 0);
+
+	clock_gettime(CLOCK_MONOTONIC, &ini);
+	for (int i = 0; i < 2 * num_threads; ++i) {
+		int err;
+
+		tarefas[i] = (Tarefa){ .rodada = r,
+				       .id = i % num_threads,
+				       .num = r->por_produtor };
+		err = pthread_create(&threads[i], NULL,
+				     i < num_threads ? produtor : consumidor,
+				     &tarefas[i]);
+
+		// Trata erro na criação da thread.
+		if (err) {
+			errno = err;
+			perror("Impossível criar thread");
+			exit(err);
+		}
+	}
+	for (int i = 0; i < 2 * num_threads; ++i)
+		pthread_join(threads[i], NULL);
+	clock_gettime(CLOCK_MONOTONIC, &fim);
+
+	seg = (fim.tv_sec - ini.tv_sec) + (fim.tv_nsec - ini.tv_nsec) / 1e9;
+	printf("%s: %d produtores, %d consumidores, %ld operações em %.3lf s "
+	       "(%.2lf Mop/s)\n",
+	       nome, num_threads, num_threads, 2 * esperados, seg,
+	       2 * esperados / seg / 1e6);
+
+	if (atomic_load(&r->consumidos) != esperados ||
+	    atomic_load(&r->soma_ids) != soma) {
+		fprintf(stderr, "%s: esperava %ld Pokémon (soma dos ids %ld), "
+				"mas foram removidos %ld (soma dos ids %ld).\n",
+			nome, esperados, soma, atomic_load(&r->consumidos),
+			atomic_load(&r->soma_ids));
+		return false;
+	}
+
+	return true;
+}
+
+// Compara a fila sem travas com uma fila protegida por uma trava global, com
+// de 1 a `max_threads` produtores e outros tantos consumidores. Retorna o
+// código de saída do programa.
+static int estresse(Pokemon **catalogo, int num_catalogo, int max_threads,
+		    long por_produtor, int capacidade)
+{
+	FilaPokemon livre;
+	FilaTravada travada = { .arr = NULL };
+	Rodada r = { .catalogo = catalogo,
+		     .num_catalogo = num_catalogo,
+		     .por_produtor = por_produtor };
+	bool ok = true;
+
+	if (max_threads < 1 || por_produtor < 1 || capacidade < 1 ||
+	    capacidade > (1 << 30) || num_catalogo < 1) {
+		fputs("Parâmetros inválidos para o teste de estresse.\n",
+		      stderr);
+		return EXIT_FAILURE;
+	}
+
+	// A fila travada usa o mesmo tamanho de array que a fila sem travas.
+	fila_init(&livre, capacidade);
+	travada.mascara = livre.mascara;
+	travada.arr = malloc(sizeof(Pokemon *[travada.mascara + 1]));
+	if (travada.arr == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para array de Pokémon");
+		exit(errsv);
+	}
+	pthread_mutex_init(&travada.trava, NULL);
+	pthread_cond_init(&travada.nao_cheia, NULL);
+	pthread_cond_init(&travada.nao_vazia, NULL);
+
+	for (int n = 1; n <= max_threads; ++n) {
+		r.fila = &livre;
+		r.insere = livre_insere;
+		r.remove = livre_remove;
+		ok = rodada("Sem trava", &r, n) && ok;
+
+		r.fila = &travada;
+		r.insere = travada_insere;
+		r.remove = travada_remove;
+		ok = rodada("Trava global", &r, n) && ok;
+	}
+
+	// As filas estão vazias, e os Pokémon pertencem ao catálogo.
+	pthread_cond_destroy(&travada.nao_vazia);
+	pthread_cond_destroy(&travada.nao_cheia);
+	pthread_mutex_destroy(&travada.trava);
+	free(travada.arr);
+	fila_free(&livre);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/// Programa principal. ///////////////////////////////////////////////////////
+
+#define NUM_PK 801 // Número máximo de Pokémon no CSV.
+#define CAP_FILA 5 // Capacidade da fila circular.
+
+int main(int argc, char **argv)
+{
+	// Stream do arquivo CSV.
+	FILE *csv = fopen((argc > 1) ? argv[1] : DEFAULT_DB, "r");
+	Pokemon *pokemon[NUM_PK] = { NULL }; // Array de Pokémon.
+	FilaPokemon *fila = NULL; // Pokémon selecionados.
+	int num_lidos = 0; // Número de Pokémon lidos.
+	char *input = NULL; // Buffer para as linhas de entrada.
+	size_t tam_input = 0; // Capacidade do buffer de entrada.
+	char cmd[10]; // Buffer para a leitura dos comandos.
+
+	// Verifica se houve erro ao abrir o CSV.
+	if (!csv) {
+		int errsv = errno;
+		perror("Falha ao abrir CSV");
+		return errsv;
+	}
+
+	// Descarta a primeira linha (cabeçalho).
+	while (fgetc(csv) != '\n')
+		;
+
+	// Lê os Pokémon do CSV.
+	while (num_lidos < NUM_PK && getline(&input, &tam_input, csv) != -1)
+		pokemon[num_lidos++] = pokemon_from_str(input);
+	fclose(csv); // Fecha o arquivo ao terminar.
+
+	// Com `-t THREADS N CAPACIDADE` após o CSV, executa o teste de estresse
+	// em vez de ler comandos da entrada padrão.
+	if (argc == 6 && !strcmp(argv[2], "-t")) {
+		int res = estresse(pokemon, num_lidos, atoi(argv[3]),
+				   atol(argv[4]), atoi(argv[5]));
+
+		free(input);
+		for (int i = 0; i < num_lidos; ++i)
+			pokemon_free(pokemon[i]);
+		return res;
+	}
+
+	// Inicializa a fila verificando erro.
+	if ((fila = malloc(sizeof(*fila))) == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para a fila");
+		exit(errsv);
+	}
+	fila_init(fila, CAP_FILA);
+
+	// Lê os índices da entrada padrão e adiciona à fila.
+	while (getline(&input, &tam_input, stdin) != -1 &&
+	       strcmp(input, "FIM\n")) {
+		inserir(fila, pokemon_clone(pokemon[atoi(input) - 1]));
+		printf("Média: %d\n", avg_capture_rate(fila));
+	}
+	free(input); // Libera o buffer dinâmico de entrada.
+
+	// Lê os comandos de inserção e remoção da fila.
+	while (scanf("%s", cmd) != EOF) {
+		if (cmd[0] == 'I') { // Caso de inserção.
+			int idx; // Índice do Pokémon a inserir.
+			scanf("%d", &idx); // Lê o ID do Pokémon.
+			--idx; // Decrementa para encontrar índice.
+
+			inserir(fila, pokemon[idx]);
+			printf("Média: %d\n", avg_capture_rate(fila));
+			// print_fila(fila);
+		} else if (cmd[0] == 'R') {
+			// Mostra o Pokémon removido.
+			Pokemon *ptr = remover(fila);
+			printf("(R) %s\n", ptr->name);
+			pokemon_free(ptr);
+		}
+	}
+
+	// Libera o arranjo original.
+	for (int i = 0; i < num_lidos; ++i)
+		pokemon_free(pokemon[i]);
+
+	// Imprime a fila resultante
+	putchar('\n'); // Linha de separação.
+	for (uint32_t i = fila->primeiro, pos = 0; i != fila->ultimo;
+	     ++i, ++pos) {
+		printf("[%u] ", pos);
+		imprimir(fila_pos(fila, i)->elemento);
+	}
+
+	fila_free(fila); // Libera a fila.
+	return EXIT_SUCCESS;
+}
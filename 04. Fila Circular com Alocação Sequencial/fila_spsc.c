@@ -0,0 +1,1033 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// De onde ler o CSV se não receber nenhum parâmetro na linha de comando.
+#define DEFAULT_DB "/tmp/pokemon.csv"
+
+/// Definições dos tipos de dados. ////////////////////////////////////////////
+
+// Tipos possíveis de Pokémon.
+enum PokeType {
+	NO_TYPE = 0,
+	BUG,
+	DARK,
+	DRAGON,
+	ELECTRIC,
+	FAIRY,
+	FIGHTING,
+	FIRE,
+	FLYING,
+	GHOST,
+	GRASS,
+	GROUND,
+	ICE,
+	NORMAL,
+	POISON,
+	PSYCHIC,
+	ROCK,
+	STEEL,
+	WATER
+};
+
+// Definição do tipo de inteiro que armazena o tipo do Pokémon. Deve ter bits
+// suficientes para todos os tipos.
+typedef uint8_t PokeType;
+
+// Lista de habilidades de um Pokémon.
+typedef struct {
+	char **list; // Lista dinâmica de strings dinâmicas.
+	uint8_t num; // Quantidade de habilidades.
+} PokeAbilities;
+
+// Data.
+typedef struct {
+	uint16_t y; // Ano.
+	uint8_t m; // Mês.
+	uint8_t d; // Dia.
+} Date;
+
+// O Pokémon em si. Usamos tipos numéricos rígidos para economizar memória.
+typedef struct {
+	// Ordenamos os membros de maior (8 bytes) para menor (1 byte) para
+	// melhorar o uso de memória, diminuindo o espaço vazio entre os
+	// membros.
+
+	// Tipos de 64 bits.
+	double weight; // Peso em quilogramas.
+	double height; // Altura em metros.
+
+	// Ponteiros de 32 ou 64 bits, dependendo da máquina.
+	char *name; // String dinâmica para o nome.
+	char *description; // String dinâmica para a descrição.
+
+	// Tipos de 32 bits.
+	Date capture_date; // Data de captura.
+
+	// Tipos de 16 bits.
+	PokeType type[2]; // Tipos do Pokémon.
+	uint16_t id; // Chave: inteiro não-negativo de 16 bits.
+	uint16_t capture_rate; // Determinante da probabilidade de captura.
+
+	// Tipos de 8 bits.
+	uint8_t generation; // Geração: inteiro não-negativo de 8 bits.
+	bool is_legendary; // Se é ou não um Pokémon lendário.
+
+	// Tipo de tamamho irregular (72 bits) no final evita a introdução de
+	// preenchimento no meio da struct.
+	PokeAbilities abilities; // Lista dinâmica das habilidades.
+} Pokemon;
+
+// Fila circular de Pokémon para um produtor e um consumidor, sem travas.
+//
+// O array tem tamanho potência de dois, e `primeiro` e `ultimo` são contadores
+// que só crescem, como na fila sequencial. Só o produtor escreve `ultimo`, e
+// só o consumidor escreve `primeiro`; cada um fica em sua linha de cache junto
+// de uma cópia do contador do outro lado, que só é relida quando a fila parece
+// cheia (no produtor) ou vazia (no consumidor).
+//
+// No modo com descarte, o produtor pode descartar o elemento mais antigo ao
+// encontrar a fila cheia, como `inserir()` da fila sequencial. Para isso, os
+// dois lados avançam `primeiro` com CAS, e o lado que perder a disputa tenta
+// de novo. As somas das taxas de captura também são separadas por escritor,
+// para que a média não precise de operações atômicas de leitura e escrita.
+#define LINHA_CACHE 64 // Tamanho de uma linha de cache.
+
+typedef struct {
+	// Campos escritos pelo produtor.
+	_Alignas(LINHA_CACHE) _Atomic uint32_t ultimo; // Contador do fim.
+	uint32_t primeiro_visto; // Última leitura de `primeiro`.
+	_Atomic int64_t soma_inseridos; // Taxas de captura inseridas.
+	_Atomic int64_t soma_descartados; // Taxas de captura descartadas.
+
+	// Campos escritos pelo consumidor.
+	_Alignas(LINHA_CACHE) _Atomic uint32_t primeiro; // Contador do início.
+	uint32_t ultimo_visto; // Última leitura de `ultimo`.
+	_Atomic int64_t soma_removidos; // Taxas de captura removidas.
+
+	// Campos constantes após `fila_init()`.
+	_Alignas(LINHA_CACHE) _Atomic(Pokemon *) *arr; // Array de ponteiros.
+	uint32_t mascara; // Tamanho do array menos um.
+	uint32_t capacidade; // Capacidade lógica.
+	bool descarta; // Se o produtor pode descartar o elemento mais antigo.
+} FilaPokemon;
+
+// Fila circular sequencial sem sincronização, usada só como referência no
+// teste de desempenho.
+typedef struct {
+	Pokemon **arr; // Array de ponteiros.
+	uint32_t mascara; // Tamanho do array menos um.
+	uint32_t capacidade; // Capacidade lógica.
+	uint32_t primeiro, ultimo; // Contadores do início e do fim.
+} FilaSequencial;
+
+// Estado compartilhado por uma rodada do teste de estresse.
+typedef struct {
+	FilaPokemon *fila; // Fila sob teste.
+	Pokemon **catalogo; // Pokémon inseridos pelo produtor.
+	int num_catalogo;
+	long num; // Pokémon inseridos pelo produtor.
+	_Atomic bool produzindo; // Se o produtor ainda não terminou.
+	long descartados; // Pokémon descartados pelo produtor.
+	long soma_descartados; // Soma dos ids dos Pokémon descartados.
+	long consumidos; // Pokémon removidos pelo consumidor.
+	long soma_consumidos; // Soma dos ids dos Pokémon removidos.
+	bool fora_de_ordem; // Se o consumidor viu algum Pokémon fora de ordem.
+} Rodada;
+
+/// Declarações de todas as funções. //////////////////////////////////////////
+
+// Funções para cumprimento da questão.
+int main(int argc, char **argv);
+
+// Funções para a implementação do objeto Pokémon.
+void ler(Pokemon *restrict p, char *str);
+void imprimir(Pokemon *restrict const p);
+Pokemon *pokemon_from_str(char *str);
+Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
+			     const char *description, const PokeType type[2],
+			     const PokeAbilities *abilities, double weight_kg,
+			     double height_m, uint16_t capture_rate,
+			     bool is_legendary, Date capture_date);
+Pokemon *pokemon_clone(const Pokemon *p);
+static inline Pokemon *pokemon_new(void);
+void pokemon_free(Pokemon *restrict p);
+static PokeAbilities abilities_from_string(char *str);
+static PokeType type_from_string(const char *str);
+static const char *type_to_string(PokeType type);
+
+// Funções para a implementação da fila.
+void fila_init(FilaPokemon *l, int capacidade, bool descarta);
+void fila_free(FilaPokemon *l);
+static inline uint32_t fila_idx(const FilaPokemon *l, uint32_t i);
+static inline void soma_acumula(_Atomic int64_t *soma, int64_t v);
+bool tentar_inserir(FilaPokemon *l, Pokemon *x);
+Pokemon *inserir_descartando(FilaPokemon *l, Pokemon *x);
+Pokemon *tentar_remover(FilaPokemon *l);
+void inserir(FilaPokemon *l, Pokemon *x);
+Pokemon *remover(FilaPokemon *l);
+int avg_capture_rate(FilaPokemon *l);
+
+// Funções para o teste de estresse e de desempenho.
+static void *produtor(void *arg);
+static void *consumidor(void *arg);
+static double segundos(const struct timespec *ini);
+static bool rodada_sequencial(Rodada *r, int capacidade);
+static bool rodada(const char *nome, Rodada *r);
+static int estresse(Pokemon **catalogo, int num_catalogo, long num,
+		    int capacidade);
+
+/// Métodos que operam nos Pokémon. ///////////////////////////////////////////
+
+// Lê um Pokémon a partir de uma string. A string é modificada.
+void ler(Pokemon *restrict p, char *str)
+{
+	// Posição inicial dos termos após a lista de habilidades. Necessária
+	// porque o método `abilities_from_string()` invalidará a string `str`
+	// antes dessa posição.
+	char *const post_list = strstr(str, "']\",") + 3;
+	char *tok = NULL; // Ponteiro temporário para as substrings (tokens).
+	char *sav = NULL; // Ponteiro auxiliar para o estado de `strtok_r()`.
+	int tok_count = 0; // Contador auxiliar de tokens.
+
+	// Verifica erro ao buscar a substring.
+	if (!post_list) {
+		int errsv = errno;
+		perror("Tentei criar Pokémon com uma string mal formada");
+		exit(errsv);
+	}
+
+	// Lê a chave (id) e a geração.
+	p->id = atoi(strtok_r(str, ",", &sav));
+	p->generation = atoi(strtok_r(NULL, ",", &sav));
+
+	// Lê o nome.
+	tok = strtok_r(NULL, ",", &sav);
+	p->name = strdup(tok);
+
+	// Lê a descrição.
+	tok = strtok_r(NULL, ",", &sav);
+	p->description = strdup(tok);
+
+	// Lê o primeiro tipo.
+	p->type[0] = type_from_string(strtok_r(NULL, ",", &sav));
+
+	// Lẽ o segundo tipo, se existir.
+	tok = strtok_r(NULL, "[,", &sav);
+	p->type[1] = (*tok == '"') ? NO_TYPE : type_from_string(tok);
+
+	// Lê a lista de habilidades.
+	p->abilities = abilities_from_string(strtok_r(NULL, "]", &sav));
+	str = post_list; // Avança para após a lista de habilidades.
+	sav = NULL; // Reseta o ponteiro de `strtok_r()`.
+
+	// Leia peso e altura, se existirem (alguns Pokémon no CSV não têm, mas
+	// todos que têm peso também têm altura, e vice-versa). Por isso,
+	// determina quantos campos não vazios restam.
+	for (int i = 0; str[i]; ++i)
+		// Vírgulas não-consecutivas indicam campo não vazio.
+		if (str[i] == ',' && str[i + 1] != ',')
+			++tok_count;
+
+	// Leia peso e altura, se existirem (alguns Pokémon no CSV não têm, mas
+	// todos que têm peso também têm altura, e vice-versa).
+	if (tok_count == 5) { // Se restam 5 itens, o peso e a altura existem.
+		p->weight = atof(strtok_r(str, ",", &sav));
+		p->height = atof(strtok_r(NULL, ",", &sav));
+	} else {
+		p->height = p->weight = 0; // Atribui um peso inválido.
+	}
+
+	// Lê o determinante da probabilidade de captura e se é lendário ou não.
+	p->capture_rate = atoi(strtok_r(sav ? NULL : str, ",", &sav));
+	p->is_legendary = atoi(strtok_r(NULL, ",", &sav));
+
+	// Lê a data de captura.
+	p->capture_date.d = atoi(strtok_r(NULL, "/", &sav));
+	p->capture_date.m = atoi(strtok_r(NULL, "/", &sav));
+	p->capture_date.y = atoi(strtok_r(NULL, "/\n\r", &sav));
+}
+
+// Printa um Pokémon recebido por referência em `stdout`.
+void imprimir(Pokemon *restrict const p)
+{
+	printf("[#%d -> %s: %s - ['%s'", p->id, p->name, p->description,
+	       type_to_string(p->type[0]));
+
+	if (p->type[1] != NO_TYPE)
+		printf(", '%s'", type_to_string(p->type[1]));
+
+	printf("] - ['%s'", p->abilities.list[0]);
+	for (int i = 1; i < p->abilities.num; ++i)
+		printf(", '%s'", p->abilities.list[i]);
+
+	printf("] - %0.1lfkg - %0.1lfm - %u%% - %s - %u gen] - %02u/%02u/%04u\n",
+	       p->weight, p->height, p->capture_rate,
+	       p->is_legendary ? "true" : "false", p->generation,
+	       p->capture_date.d, p->capture_date.m, p->capture_date.y);
+}
+
+// Aloca um Pokémon a partir de uma string.
+Pokemon *pokemon_from_str(char *str)
+{
+	Pokemon *res = pokemon_new();
+	ler(res, str);
+	return res;
+}
+
+// Aloca um Pokémon a partir de parâmetros.
+Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
+			     const char *description, const PokeType type[2],
+			     const PokeAbilities *abilities, double weight_kg,
+			     double height_m, uint16_t capture_rate,
+			     bool is_legendary, Date capture_date)
+{
+	Pokemon *res = pokemon_new();
+
+	// Precisamos criar uma cópia profunda da lista de habilidades.
+	PokeAbilities ablist_clone = { .num = abilities->num };
+	ablist_clone.list = malloc(ablist_clone.num * sizeof(char *));
+	for (int i = 0; i < ablist_clone.num; ++i)
+		ablist_clone.list[i] = strdup(abilities->list[i]);
+
+	*res = (Pokemon){ .id = id,
+			  .generation = generation,
+			  .name = strdup(name),
+			  .description = strdup(description),
+			  .type[0] = type[0],
+			  .type[1] = type[1],
+			  .abilities = ablist_clone,
+			  .weight = weight_kg,
+			  .height = height_m,
+			  .capture_rate = capture_rate,
+			  .is_legendary = is_legendary,
+			  .capture_date = capture_date };
+	return res;
+}
+
+// Duplica um Pokemón.
+Pokemon *pokemon_clone(const Pokemon *p)
+{
+	return pokemon_from_params(p->id, p->generation, p->name,
+				   p->description, p->type, &p->abilities,
+				   p->weight, p->height, p->capture_rate,
+				   p->is_legendary, p->capture_date);
+}
+
+// Aloca um Pokémon vazio dinamicamente.
+static inline Pokemon *pokemon_new(void)
+{
+	Pokemon *res = calloc(1, sizeof(Pokemon));
+	if (!res) {
+		int errsv = errno;
+		perror("Impossível alocar memória para Pokémon");
+		exit(errsv);
+	}
+	return res;
+}
+
+// Libera um Pokémon alocado dinamicamente.
+void pokemon_free(Pokemon *restrict p)
+{
+	if (p != NULL) {
+		free(p->name);
+		free(p->description);
+		for (int i = 0; i < p->abilities.num; ++i)
+			free(p->abilities.list[i]);
+		free(p->abilities.list);
+		free(p);
+	}
+}
+
+// Cria uma lista dinâmica de habilidades a partir de uma representação textual.
+static PokeAbilities abilities_from_string(char *str)
+{
+	PokeAbilities res = { .num = 1 }; // Há no mínimo uma habilidade.
+	char *sav = NULL;
+
+	// Conta o número de habilidades a partir das vírgulas na string.
+	for (int i = 0; str[i] && str[i] != ']'; ++i)
+		if (str[i] == ',')
+			++res.num;
+	// Aloca memória para a lista dinâmica.
+	res.list = malloc(res.num * sizeof(char *));
+	if (!res.list) {
+		int errsv = errno;
+		perror("Impossível alocar memória para lista de habilidades");
+		exit(errsv);
+	}
+
+	// Lê cada uma das habilidades.
+	for (int i = 0; i < res.num; ++i) {
+		char *ability; // Ponteiro temporário para a substring (token).
+		int token_len = 0; // Contador to tamanho do token `ability`.
+
+		// Extrai um token da lista.
+		ability = strtok_r(i ? NULL : str, ",]", &sav);
+		if (!ability) {
+			int errsv = errno;
+			for (int j = 0; j < i; ++j) {
+				free(res.list[j]);
+			}
+			free(res.list);
+			res.list = NULL;
+			res.num = 0;
+			perror("Erro ao extrair habilidade da string");
+			exit(errsv);
+		}
+
+		// Remove quaisquer caracteres exceto letras, números e espaços.
+		for (int j = 0; ability[j]; ++j)
+			if (isalnum(ability[j]) || isspace(ability[j]))
+				ability[token_len++] = ability[j];
+		ability[token_len] = '\0'; // Termina o token.
+
+		// Remove espaços e aspas iniciais.
+		while (*ability == ' ' || *ability == '\'') {
+			++ability;
+			--token_len;
+		}
+
+		// Remove espaços e aspas finais.
+		while (token_len > 0 && (ability[token_len - 1] == ' ' ||
+					 ability[token_len - 1] == '\''))
+			ability[--token_len] = '\0';
+
+		// Aloca a memória para a habilidade e a salva no struct.
+		res.list[i] = strdup(ability);
+		if (!res.list[i]) {
+			int errsv = errno;
+			for (int j = 0; j < i; ++j) {
+				free(res.list[j]);
+			}
+			free(res.list);
+			res.list = NULL;
+			res.num = 0;
+			perror("Impossível alocar memória para habilidade");
+			exit(errsv);
+		}
+	}
+
+	return res;
+}
+
+// Converte a representação textual do tipo em um dado PokeType.
+static PokeType type_from_string(const char *str)
+{
+	enum PokeType res;
+
+	if (!strcmp(str, "bug"))
+		res = BUG;
+	else if (!strcmp(str, "dark"))
+		res = DARK;
+	else if (!strcmp(str, "dragon"))
+		res = DRAGON;
+	else if (!strcmp(str, "electric"))
+		res = ELECTRIC;
+	else if (!strcmp(str, "fairy"))
+		res = FAIRY;
+	else if (!strcmp(str, "fighting"))
+		res = FIGHTING;
+	else if (!strcmp(str, "fire"))
+		res = FIRE;
+	else if (!strcmp(str, "flying"))
+		res = FLYING;
+	else if (!strcmp(str, "ghost"))
+		res = GHOST;
+	else if (!strcmp(str, "grass"))
+		res = GRASS;
+	else if (!strcmp(str, "ground"))
+		res = GROUND;
+	else if (!strcmp(str, "ice"))
+		res = ICE;
+	else if (!strcmp(str, "normal"))
+		res = NORMAL;
+	else if (!strcmp(str, "poison"))
+		res = POISON;
+	else if (!strcmp(str, "psychic"))
+		res = PSYCHIC;
+	else if (!strcmp(str, "rock"))
+		res = ROCK;
+	else if (!strcmp(str, "steel"))
+		res = STEEL;
+	else if (!strcmp(str, "water"))
+		res = WATER;
+	else
+		res = NO_TYPE;
+
+	return res;
+}
+
+// Converte um dado PokeType em sua representação textual.
+static const char *type_to_string(PokeType type)
+{
+	const char *res = NULL;
+	switch (type) {
+	case BUG:
+		res = "bug";
+		break;
+	case DARK:
+		res = "dark";
+		break;
+	case DRAGON:
+		res = "dragon";
+		break;
+	case ELECTRIC:
+		res = "electric";
+		break;
+	case FAIRY:
+		res = "fairy";
+		break;
+	case FIGHTING:
+		res = "fighting";
+		break;
+	case FIRE:
+		res = "fire";
+		break;
+	case FLYING:
+		res = "flying";
+		break;
+	case GHOST:
+		res = "ghost";
+		break;
+	case GRASS:
+		res = "grass";
+		break;
+	case GROUND:
+		res = "ground";
+		break;
+	case ICE:
+		res = "ice";
+		break;
+	case NORMAL:
+		res = "normal";
+		break;
+	case POISON:
+		res = "poison";
+		break;
+	case PSYCHIC:
+		res = "psychic";
+		break;
+	case ROCK:
+		res = "rock";
+		break;
+	case STEEL:
+		res = "steel";
+		break;
+	case WATER:
+		res = "water";
+		break;
+	default:
+		fputs("FATAL: Pokémon tem um tipo desconhecido!\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return res;
+}
+
+/// Métodos que operam na fila SPSC de Pokémon. ///////////////////////////////
+
+// Instancia uma fila de Pokémon. O array é arredondado para a próxima potência
+// de dois, e cada contador fica em sua própria linha de cache. Com `descarta`,
+// a fila aceita `inserir_descartando()` e `inserir()`.
+void fila_init(FilaPokemon *l, int capacidade, bool descarta)
+{
+	uint32_t tam = 1;
+
+	if (capacidade < 1 || capacidade > (1 << 30)) {
+		fputs("Capacidade inválida para a fila.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	while (tam < (uint32_t)capacidade)
+		tam <<= 1;
+
+	memset(l, 0, sizeof(*l));
+	l->arr = calloc(tam, sizeof(*l->arr));
+	l->mascara = tam - 1;
+	l->capacidade = capacidade;
+	l->descarta = descarta;
+
+	// Trata erro na alocação.
+	if (l->arr == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para array de Pokémon");
+		exit(errsv);
+	}
+
+	for (uint32_t i = 0; i < tam; ++i)
+		atomic_init(&l->arr[i], NULL);
+	atomic_init(&l->ultimo, 0);
+	atomic_init(&l->primeiro, 0);
+	atomic_init(&l->soma_inseridos, 0);
+	atomic_init(&l->soma_descartados, 0);
+	atomic_init(&l->soma_removidos, 0);
+}
+
+// Libera a fila de Pokémon, e todos os Pokémon contidos. Nenhuma outra thread
+// pode estar usando a fila.
+void fila_free(FilaPokemon *l)
+{
+	uint32_t fim = atomic_load(&l->ultimo);
+
+	for (uint32_t i = atomic_load(&l->primeiro); i != fim; ++i)
+		pokemon_free(atomic_load(&l->arr[fila_idx(l, i)]));
+
+	// Libera o arranjo e zera os campos do struct.
+	free(l->arr);
+	memset(l, 0, sizeof(*l));
+}
+
+// Posição no array do contador `i`.
+static inline uint32_t fila_idx(const FilaPokemon *l, uint32_t i)
+{
+	return i & l->mascara;
+}
+
+// Acumula `v` em uma soma que só a thread atual escreve, sem precisar de uma
+// operação atômica de leitura e escrita.
+static inline void soma_acumula(_Atomic int64_t *soma, int64_t v)
+{
+	atomic_store_explicit(
+		soma, atomic_load_explicit(soma, memory_order_relaxed) + v,
+		memory_order_relaxed);
+}
+
+// Insere `x` no fim da fila, sem duplicá-lo. Só pode ser chamada pelo
+// produtor. Retorna false, sem inserir, se a fila estiver cheia.
+bool tentar_inserir(FilaPokemon *l, Pokemon *x)
+{
+	uint32_t u = atomic_load_explicit(&l->ultimo, memory_order_relaxed);
+
+	// Só relê `primeiro`, que está na linha de cache do consumidor, quando
+	// a cópia local indica que a fila está cheia.
+	if (u - l->primeiro_visto >= l->capacidade) {
+		l->primeiro_visto = atomic_load_explicit(&l->primeiro,
+							 memory_order_acquire);
+		if (u - l->primeiro_visto >= l->capacidade)
+			return false;
+	}
+
+	atomic_store_explicit(&l->arr[fila_idx(l, u)], x,
+			      memory_order_relaxed);
+	soma_acumula(&l->soma_inseridos, x->capture_rate);
+
+	// Publica o elemento para o consumidor.
+	atomic_store_explicit(&l->ultimo, u + 1, memory_order_release);
+	return true;
+}
+
+// Insere `x` no fim da fila, sem duplicá-lo, descartando o elemento mais
+// antigo se a fila estiver cheia. Só pode ser chamada pelo produtor, e só em
+// filas com descarte. Retorna o elemento descartado, ou NULL.
+Pokemon *inserir_descartando(FilaPokemon *l, Pokemon *x)
+{
+	Pokemon *descartado = NULL;
+
+	while (!tentar_inserir(l, x)) {
+		// A fila está cheia: tenta tirar o primeiro elemento antes do
+		// consumidor. Se perder, a fila deixou de estar cheia.
+		uint32_t p = l->primeiro_visto;
+		Pokemon *y = atomic_load_explicit(&l->arr[fila_idx(l, p)],
+						  memory_order_relaxed);
+
+		if (atomic_compare_exchange_strong_explicit(
+			    &l->primeiro, &p, p + 1, memory_order_acq_rel,
+			    memory_order_acquire)) {
+			soma_acumula(&l->soma_descartados, y->capture_rate);
+			descartado = y;
+		}
+	}
+
+	return descartado;
+}
+
+// Remove e retorna o primeiro elemento da fila, ou NULL se ela estiver vazia.
+// Só pode ser chamada pelo consumidor.
+Pokemon *tentar_remover(FilaPokemon *l)
+{
+	uint32_t p = atomic_load_explicit(&l->primeiro, memory_order_relaxed);
+	Pokemon *x = NULL;
+
+	for (;;) {
+		// Só relê `ultimo`, que está na linha de cache do produtor,
+		// quando a cópia local indica que a fila está vazia. Com
+		// descarte, `p` pode ter passado da cópia, por isso a distância
+		// é comparada com sinal.
+		if ((int32_t)(l->ultimo_visto - p) <= 0) {
+			l->ultimo_visto = atomic_load_explicit(
+				&l->ultimo, memory_order_acquire);
+			if (l->ultimo_visto == p)
+				return NULL;
+		}
+
+		x = atomic_load_explicit(&l->arr[fila_idx(l, p)],
+					 memory_order_relaxed);
+
+		// Sem descarte, só o consumidor avança `primeiro`.
+		if (!l->descarta) {
+			atomic_store_explicit(&l->primeiro, p + 1,
+					      memory_order_release);
+			break;
+		}
+
+		// Com descarte, o produtor pode ter tirado o elemento antes. A
+		// falha no CAS atualiza `p` e tenta de novo.
+		if (atomic_compare_exchange_strong_explicit(
+			    &l->primeiro, &p, p + 1, memory_order_acq_rel,
+			    memory_order_acquire))
+			break;
+	}
+
+	soma_acumula(&l->soma_removidos, x->capture_rate);
+	return x;
+}
+
+// Funções de inserção na fila, com a semântica da fila sequencial: o Pokémon
+// inserido é duplicado e, se a fila estiver cheia, o mais antigo é liberado.
+void inserir(FilaPokemon *l, Pokemon *x)
+{
+	if (!l->descarta) {
+		fputs("A fila não permite descarte.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	pokemon_free(inserir_descartando(l, pokemon_clone(x)));
+}
+
+// Funções de remoção da fila.
+Pokemon *remover(FilaPokemon *l)
+{
+	Pokemon *resp = tentar_remover(l);
+
+	if (!resp) {
+		fputs("A fila já está vazia.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return resp;
+}
+
+// Retorna a média das taxas de captura na fila, em O(1). É exata quando não
+// há inserções ou remoções em andamento.
+int avg_capture_rate(FilaPokemon *l)
+{
+	uint32_t num = atomic_load(&l->ultimo) - atomic_load(&l->primeiro);
+	int64_t soma = atomic_load(&l->soma_inseridos) -
+		       atomic_load(&l->soma_descartados) -
+		       atomic_load(&l->soma_removidos);
+
+	if (!num) {
+		fputs("A fila está vazia.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return (int)round((double)soma / num);
+}
+
+/// Teste de estresse e de desempenho. ////////////////////////////////////////
+
+// Produtor: insere `num` Pokémon do catálogo, em ordem. Sem descarte, espera
+// quando a fila está cheia; com descarte, conta os Pokémon descartados.
+static void *produtor(void *arg)
+{
+	Rodada *r = arg;
+
+	for (long j = 0; j < r->num; ++j) {
+		Pokemon *x = r->catalogo[j % r->num_catalogo];
+
+		if (r->fila->descarta) {
+			Pokemon *y = inserir_descartando(r->fila, x);
+			if (y) {
+				r->descartados += 1;
+				r->soma_descartados += y->id;
+			}
+		} else {
+			while (!tentar_inserir(r->fila, x))
+				sched_yield();
+		}
+	}
+
+	atomic_store(&r->produzindo, false);
+	return NULL;
+}
+
+// Consumidor: remove até que o produtor termine e a fila esvazie, somando
+// quantos Pokémon removeu e seus ids. Sem descarte, verifica também que os
+// Pokémon saem na mesma ordem em que entraram.
+static void *consumidor(void *arg)
+{
+	Rodada *r = arg;
+
+	for (;;) {
+		Pokemon *x = tentar_remover(r->fila);
+
+		// Se a fila parece vazia, só termina quando o produtor tiver
+		// terminado e ela continuar vazia.
+		if (!x) {
+			if (atomic_load(&r->produzindo)) {
+				sched_yield();
+				continue;
+			}
+			if (!(x = tentar_remover(r->fila)))
+				break;
+		}
+
+		if (!r->fila->descarta &&
+		    x != r->catalogo[r->consumidos % r->num_catalogo])
+			r->fora_de_ordem = true;
+
+		r->consumidos += 1;
+		r->soma_consumidos += x->id;
+	}
+
+	return NULL;
+}
+
+// Segundos decorridos desde `ini`.
+static double segundos(const struct timespec *ini)
+{
+	struct timespec fim;
+
+	clock_gettime(CLOCK_MONOTONIC, &fim);
+	return (fim.tv_sec - ini->tv_sec) + (fim.tv_nsec - ini->tv_nsec) / 1e9;
+}
+
+// Executa, em uma só thread, a mesma carga na fila sequencial sem
+// sincronização: insere cada Pokémon, removendo o mais antigo quando a fila
+// está cheia, e esvazia a fila no final. Retorna se a ordem foi mantida.
+static bool rodada_sequencial(Rodada *r, int capacidade)
+{
+	FilaSequencial l;
+	struct timespec ini;
+	uint32_t tam = 1;
+	long saidos = 0;
+	bool ok = true;
+	double seg;
+
+	while (tam < (uint32_t)capacidade)
+		tam <<= 1;
+
+	l = (FilaSequencial){ .arr = malloc(sizeof(Pokemon *[tam])),
+			      .mascara = tam - 1,
+			      .capacidade = capacidade };
+
+	// Trata erro na alocação.
+	if (l.arr == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para array de Pokémon");
+		exit(errsv);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ini);
+	for (long j = 0; j < r->num || l.primeiro != l.ultimo;) {
+		if (j < r->num && l.ultimo - l.primeiro < l.capacidade) {
+			l.arr[l.ultimo++ & l.mascara] =
+				r->catalogo[j++ % r->num_catalogo];
+			continue;
+		}
+
+		ok = ok && l.arr[l.primeiro & l.mascara] ==
+				   r->catalogo[saidos % r->num_catalogo];
+		l.primeiro += 1;
+		saidos += 1;
+	}
+	seg = segundos(&ini);
+
+	printf("Sequencial: %ld operações em %.3lf s (%.2lf Mop/s)\n",
+	       2 * r->num, seg, 2 * r->num / seg / 1e6);
+
+	free(l.arr);
+	return ok && saidos == r->num;
+}
+
+// Executa uma rodada com um produtor e um consumidor, verifica que cada
+// Pokémon inserido foi removido ou descartado exatamente uma vez, e mostra a
+// vazão. Retorna se a verificação teve sucesso.
+static bool rodada(const char *nome, Rodada *r)
+{
+	pthread_t threads[2];
+	struct timespec ini;
+	long soma = 0;
+	double seg;
+
+	// Calcula a soma dos ids que o produtor vai inserir.
+	for (long j = 0; j < r->num; ++j)
+		soma += r->catalogo[j % r->num_catalogo]->id;
+
+	atomic_store(&r->produzindo, true);
+	r->descartados = r->soma_descartados = 0;
+	r->consumidos = r->soma_consumidos = 0;
+	r->fora_de_ordem = false;
+
+	clock_gettime(CLOCK_MONOTONIC, &ini);
+	for (int i = 0; i < 2; ++i) {
+		int err = pthread_create(&threads[i], NULL,
+					 i ? consumidor : produtor, r);
+
+		// Trata erro na criação da thread.
+		if (err) {
+			errno = err;
+			perror("Impossível criar thread");
+			exit(err);
+		}
+	}
+	for (int i = 0; i < 2; ++i)
+		pthread_join(threads[i], NULL);
+	seg = segundos(&ini);
+
+	printf("%s: %ld operações em %.3lf s (%.2lf Mop/s), %ld descartados\n",
+	       nome, 2 * r->num, seg, 2 * r->num / seg / 1e6, r->descartados);
+
+	if (r->fora_de_ordem ||
+	    r->consumidos + r->descartados != r->num ||
+	    r->soma_consumidos + r->soma_descartados != soma) {
+		fprintf(stderr, "%s: esperava %ld Pokémon (soma dos ids %ld), "
+				"mas saíram %ld (soma dos ids %ld)%s.\n",
+			nome, r->num, soma, r->consumidos + r->descartados,
+			r->soma_consumidos + r->soma_descartados,
+			r->fora_de_ordem ? ", fora de ordem" : "");
+		return false;
+	}
+
+	return true;
+}
+
+// Compara a fila SPSC, com e sem descarte, com a fila sequencial em uma só
+// thread, sob a mesma carga. Retorna o código de saída do programa.
+static int estresse(Pokemon **catalogo, int num_catalogo, long num,
+		    int capacidade)
+{
+	FilaPokemon fila;
+	Rodada r = { .fila = &fila,
+		     .catalogo = catalogo,
+		     .num_catalogo = num_catalogo,
+		     .num = num };
+	bool ok;
+
+	if (num < 1 || capacidade < 1 || capacidade > (1 << 30) ||
+	    num_catalogo < 1) {
+		fputs("Parâmetros inválidos para o teste de estresse.\n",
+		      stderr);
+		return EXIT_FAILURE;
+	}
+
+	ok = rodada_sequencial(&r, capacidade);
+
+	// As filas ficam vazias, e os Pokémon pertencem ao catálogo.
+	fila_init(&fila, capacidade, false);
+	ok = rodada("SPSC", &r) && ok;
+	fila_free(&fila);
+
+	fila_init(&fila, capacidade, true);
+	ok = rodada("SPSC com descarte", &r) && ok;
+	fila_free(&fila);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/// Programa principal. ///////////////////////////////////////////////////////
+
+#define NUM_PK 801 // Número máximo de Pokémon no CSV.
+#define CAP_FILA 5 // Capacidade da fila circular.
+
+int main(int argc, char **argv)
+{
+	// Stream do arquivo CSV.
+	FILE *csv = fopen((argc > 1) ? argv[1] : DEFAULT_DB, "r");
+	Pokemon *pokemon[NUM_PK] = { NULL }; // Array de Pokémon.
+	FilaPokemon *fila = NULL; // Pokémon selecionados.
+	int num_lidos = 0; // Número de Pokémon lidos.
+	char *input = NULL; // Buffer para as linhas de entrada.
+	size_t tam_input = 0; // Capacidade do buffer de entrada.
+	char cmd[10]; // Buffer para a leitura dos comandos.
+
+	// Verifica se houve erro ao abrir o CSV.
+	if (!csv) {
+		int errsv = errno;
+		perror("Falha ao abrir CSV");
+		return errsv;
+	}
+
+	// Descarta a primeira linha (cabeçalho).
+	while (fgetc(csv) != '\n')
+		;
+
+	// Lê os Pokémon do CSV.
+	while (num_lidos < NUM_PK && getline(&input, &tam_input, csv) != -1)
+		pokemon[num_lidos++] = pokemon_from_str(input);
+	fclose(csv); // Fecha o arquivo ao terminar.
+
+	// Com `-t N CAPACIDADE` após o CSV, executa o teste de estresse em vez
+	// de ler comandos da entrada padrão.
+	if (argc == 5 && !strcmp(argv[2], "-t")) {
+		int res = estresse(pokemon, num_lidos, atol(argv[3]),
+				   atoi(argv[4]));
+
+		free(input);
+		for (int i = 0; i < num_lidos; ++i)
+			pokemon_free(pokemon[i]);
+		return res;
+	}
+
+	// Inicializa a fila verificando erro. Em uma só thread, a fila com
+	// descarte se comporta como a fila sequencial.
+	if ((fila = malloc(sizeof(*fila))) == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para a fila");
+		exit(errsv);
+	}
+	fila_init(fila, CAP_FILA, true);
+
+	// Lê os índices da entrada padrão e adiciona à fila.
+	while (getline(&input, &tam_input, stdin) != -1 &&
+	       strcmp(input, "FIM\n")) {
+		inserir(fila, pokemon_clone(pokemon[atoi(input) - 1]));
+		printf("Média: %d\n", avg_capture_rate(fila));
+	}
+	free(input); // Libera o buffer dinâmico de entrada.
+
+	// Lê os comandos de inserção e remoção da fila.
+	while (scanf("%s", cmd) != EOF) {
+		if (cmd[0] == 'I') { // Caso de inserção.
+			int idx; // Índice do Pokémon a inserir.
+			scanf("%d", &idx); // Lê o ID do Pokémon.
+			--idx; // Decrementa para encontrar índice.
+
+			inserir(fila, pokemon[idx]);
+			printf("Média: %d\n", avg_capture_rate(fila));
+			// print_fila(fila);
+		} else if (cmd[0] == 'R') {
+			// Mostra o Pokémon removido.
+			Pokemon *ptr = remover(fila);
+			printf("(R) %s\n", ptr->name);
+			pokemon_free(ptr);
+		}
+	}
+
+	// Libera o arranjo original.
+	for (int i = 0; i < num_lidos; ++i)
+		pokemon_free(pokemon[i]);
+
+	// Imprime a fila resultante
+	putchar('\n'); // Linha de separação.
+	for (uint32_t i = fila->primeiro, pos = 0; i != fila->ultimo;
+	     ++i, ++pos) {
+		printf("[%u] ", pos);
+		imprimir(atomic_load(&fila->arr[fila_idx(fila, i)]));
+	}
+
+	fila_free(fila); // Libera a fila.
+	return EXIT_SUCCESS;
+}
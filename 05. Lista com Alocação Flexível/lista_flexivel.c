@@ -90,9 +90,33 @@ typedef struct Celula {
 	struct Celula *prox;
 } Celula;
 
+// Página do pool de células. As células são recortadas de páginas grandes, de
+// modo que células vizinhas na estrutura tendem a ficar vizinhas na memória.
+#define CELULAS_POR_PAGINA 4096 // Cada página ocupa 64 KiB.
+
+typedef struct Pagina {
+	struct Pagina *prox; // Próxima página do pool.
+	Celula celulas[CELULAS_POR_PAGINA];
+} Pagina;
+
+// Pool de células. As células devolvidas formam uma lista encadeada pelo
+// próprio campo `prox`, e são reaproveitadas antes de recortar novas.
+typedef struct {
+	Pagina *paginas; // Páginas alocadas; a primeira é a atual.
+	Celula *livres; // Lista de células devolvidas.
+	int usadas; // Células já recortadas da página atual.
+} PoolCelulas;
+
 typedef struct ListaPokemon {
 	int n;
 	Celula *cabeca, *ult;
+	PoolCelulas pool; // Origem de todas as células da lista.
+
+	// Cursor: a última célula alcançada por uma caminhada, e sua posição
+	// (-1 para a cabeça). Caminhadas para posições a partir dele não
+	// precisam recomeçar da cabeça.
+	Celula *cursor;
+	int cursor_pos;
 } ListaPokemon;
 
 /// Declarações de todas as funções. //////////////////////////////////////////
@@ -116,8 +140,14 @@ static PokeAbilities abilities_from_string(char *str);
 static PokeType type_from_string(const char *str);
 static const char *type_to_string(PokeType type);
 
+// Funções para a implementação do pool de células.
+static Celula *pool_aloca(PoolCelulas *p);
+static void pool_devolve(PoolCelulas *p, Celula *c);
+static void pool_free(PoolCelulas *p);
+
 // Funções para a implementação da lista.
-Celula *celula_new(Pokemon *x);
+Celula *celula_new(ListaPokemon *l, Pokemon *x);
+static Celula *celula_em(ListaPokemon *l, int pos);
 ListaPokemon *lista_new(void);
 void lista_free(ListaPokemon *l);
 void inserir(ListaPokemon *l, Pokemon *x, int pos);
@@ -475,30 +505,102 @@ static const char *type_to_string(PokeType type)
 	return res;
 }
 
+/// Métodos que operam no pool de células. ////////////////////////////////////
+
+// Obtém uma célula zerada do pool, reaproveitando uma devolvida se houver.
+static Celula *pool_aloca(PoolCelulas *p)
+{
+	Celula *ret = p->livres;
+
+	if (ret) {
+		p->livres = ret->prox;
+	} else {
+		// Aloca uma nova página se a atual já foi toda recortada.
+		if (!p->paginas || p->usadas == CELULAS_POR_PAGINA) {
+			Pagina *pag = malloc(sizeof(*pag));
+
+			// Trata erro na alocação.
+			if (pag == NULL) {
+				int errsv = errno;
+				perror("Impossível alocar página de células");
+				exit(errsv);
+			}
+
+			pag->prox = p->paginas;
+			p->paginas = pag;
+			p->usadas = 0;
+		}
+
+		ret = &p->paginas->celulas[p->usadas++];
+	}
+
+	memset(ret, 0, sizeof(*ret));
+	return ret;
+}
+
+// Devolve uma célula ao pool.
+static void pool_devolve(PoolCelulas *p, Celula *c)
+{
+	c->prox = p->livres;
+	p->livres = c;
+}
+
+// Libera de uma só vez todas as páginas do pool, e todas as suas células.
+static void pool_free(PoolCelulas *p)
+{
+	for (Pagina *i = p->paginas, *prox; i; i = prox) {
+		prox = i->prox;
+		free(i);
+	}
+
+	memset(p, 0, sizeof(*p));
+}
+
 /// Métodos que operam na lista flexível de Pokémon. //////////////////////////
 
-// Instancia uma célula de Pokémon.
-Celula *celula_new(Pokemon *x)
+// Instancia uma célula de Pokémon, obtida do pool da lista.
+Celula *celula_new(ListaPokemon *l, Pokemon *x)
 {
-	Celula *ret = calloc(1, sizeof(*ret));
+	Celula *ret = pool_aloca(&l->pool);
 	ret->elemento = x ? pokemon_clone(x) : NULL;
 	return ret;
 }
 
+// Retorna a célula na posição `pos`, entre -1 (a cabeça) e `n - 1`. A
+// caminhada parte do cursor se ele não estiver depois da posição, e o cursor
+// passa a apontar para a célula encontrada.
+static Celula *celula_em(ListaPokemon *l, int pos)
+{
+	Celula *ret = l->cabeca;
+	int i = -1;
+
+	if (l->cursor_pos <= pos) {
+		ret = l->cursor;
+		i = l->cursor_pos;
+	}
+
+	for (; i < pos; ++i)
+		ret = ret->prox;
+
+	l->cursor = ret;
+	l->cursor_pos = pos;
+	return ret;
+}
+
 // Instancia uma lista de Pokémon.
 ListaPokemon *lista_new(void)
 {
 	ListaPokemon *ret = calloc(1, sizeof(*ret));
-	ret->cabeca = celula_new(NULL);
+	ret->cabeca = celula_new(ret, NULL);
 	ret->ult = ret->cabeca;
+	ret->cursor = ret->cabeca;
+	ret->cursor_pos = -1;
 	return ret;
 }
 
 // Libera a lista de Pokémon, e todos os Pokémon contidos.
 void lista_free(ListaPokemon *l)
 {
-	Celula *ant = l->cabeca; // Celula anterior.
-
 	for (Celula *i = l->cabeca->prox; i; i = i->prox) {
 		Pokemon *ptr = i->elemento;
 		if (ptr) {
@@ -512,10 +614,10 @@ void lista_free(ListaPokemon *l)
 				if (j->elemento == ptr)
 					j->elemento = NULL;
 		}
-		free(ant);
-		ant = i;
 	}
 
+	// As células são liberadas de uma vez, junto com as páginas do pool.
+	pool_free(&l->pool);
 	free(l);
 }
 
@@ -531,12 +633,9 @@ void inserir(ListaPokemon *l, Pokemon *x, int pos)
 		inserir_fim(l, x);
 	} else {
 		Celula *tmp;
-		Celula *ant = l->cabeca;
-
-		for (int i = 0; i < pos; ++i)
-			ant = ant->prox;
+		Celula *ant = celula_em(l, pos - 1);
 
-		tmp = celula_new(x);
+		tmp = celula_new(l, x);
 		tmp->prox = ant->prox;
 		ant->prox = tmp;
 
@@ -546,18 +645,20 @@ void inserir(ListaPokemon *l, Pokemon *x, int pos)
 
 void inserir_inicio(ListaPokemon *l, Pokemon *x)
 {
-	Celula *nova_cabeca = celula_new(NULL);
+	Celula *nova_cabeca = celula_new(l, NULL);
 
 	nova_cabeca->prox = l->cabeca;
 	l->cabeca->elemento = pokemon_clone(x);
 	l->cabeca = nova_cabeca;
 
+	// Todas as células avançam uma posição, inclusive a do cursor.
+	l->cursor_pos += 1;
 	l->n += 1;
 }
 
 void inserir_fim(ListaPokemon *l, Pokemon *x)
 {
-	Celula *novo_ultimo = celula_new(x);
+	Celula *novo_ultimo = celula_new(l, x);
 
 	l->ult->prox = novo_ultimo;
 	l->ult = novo_ultimo;
@@ -580,15 +681,14 @@ Pokemon *remover(ListaPokemon *l, int pos)
 		ret = remover_inicio(l);
 	} else {
 		Celula *tmp;
-		Celula *ant = l->cabeca;
-
-		for (int i = 0; i < pos; ++i)
-			ant = ant->prox;
+		Celula *ant = celula_em(l, pos - 1);
 
 		tmp = ant->prox;
 		ret = tmp->elemento;
 		ant->prox = tmp->prox;
-		free(tmp);
+		if (tmp == l->ult)
+			l->ult = ant; // Não deixa `ult` pendente.
+		pool_devolve(&l->pool, tmp);
 
 		l->n -= 1;
 	}
@@ -611,7 +711,14 @@ Pokemon *remover_inicio(ListaPokemon *l)
 	l->cabeca->elemento = NULL;
 	l->n -= 1;
 
-	free(cabeca_antiga);
+	// Todas as células recuam uma posição. Se o cursor estava na cabeça
+	// antiga, passa para a nova.
+	if (l->cursor == cabeca_antiga)
+		l->cursor = l->cabeca;
+	else
+		l->cursor_pos -= 1;
+
+	pool_devolve(&l->pool, cabeca_antiga);
 	return ret;
 }
 
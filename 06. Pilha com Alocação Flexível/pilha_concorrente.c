@@ -0,0 +1,1015 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// De onde ler o CSV se não receber nenhum parâmetro na linha de comando.
+#define DEFAULT_DB "/tmp/pokemon.csv"
+
+/// Definições dos tipos de dados. ////////////////////////////////////////////
+
+// Tipos possíveis de Pokémon.
+enum PokeType {
+	NO_TYPE = 0,
+	BUG,
+	DARK,
+	DRAGON,
+	ELECTRIC,
+	FAIRY,
+	FIGHTING,
+	FIRE,
+	FLYING,
+	GHOST,
+	GRASS,
+	GROUND,
+	ICE,
+	NORMAL,
+	POISON,
+	PSYCHIC,
+	ROCK,
+	STEEL,
+	WATER
+};
+
+// Definição do tipo de inteiro que armazena o tipo do Pokémon. Deve ter bits
+// suficientes para todos os tipos.
+typedef uint8_t PokeType;
+
+// Lista de habilidades de um Pokémon.
+typedef struct {
+	char **list; // Lista dinâmica de strings dinâmicas.
+	uint8_t num; // Quantidade de habilidades.
+} PokeAbilities;
+
+// Data.
+typedef struct {
+	uint16_t y; // Ano.
+	uint8_t m; // Mês.
+	uint8_t d; // Dia.
+} Date;
+
+// O Pokémon em si. Usamos tipos numéricos rígidos para economizar memória.
+typedef struct {
+	// Ordenamos os membros de maior (8 bytes) para menor (1 byte) para
+	// melhorar o uso de memória, diminuindo o espaço vazio entre os
+	// membros.
+
+	// Tipos de 64 bits.
+	double weight; // Peso em quilogramas.
+	double height; // Altura em metros.
+
+	// Ponteiros de 32 ou 64 bits, dependendo da máquina.
+	char *name; // String dinâmica para o nome.
+	char *description; // String dinâmica para a descrição.
+
+	// Tipos de 32 bits.
+	Date capture_date; // Data de captura.
+
+	// Tipos de 16 bits.
+	PokeType type[2]; // Tipos do Pokémon.
+	uint16_t id; // Chave: inteiro não-negativo de 16 bits.
+	uint16_t capture_rate; // Determinante da probabilidade de captura.
+
+	// Tipos de 8 bits.
+	uint8_t generation; // Geração: inteiro não-negativo de 8 bits.
+	bool is_legendary; // Se é ou não um Pokémon lendário.
+
+	// Tipo de tamamho irregular (72 bits) no final evita a introdução de
+	// preenchimento no meio da struct.
+	PokeAbilities abilities; // Lista dinâmica das habilidades.
+} Pokemon;
+
+// Pilha flexível concorrente de Pokémon, sem travas (pilha de Treiber).
+//
+// Os nós ficam em blocos que só são liberados junto com a pilha, e são
+// identificados por índices de 32 bits. O topo guarda, junto do índice, uma
+// etiqueta incrementada a cada troca, de modo que um CAS feito com um topo
+// antigo falha mesmo que o mesmo nó tenha voltado ao topo (problema ABA). Nós
+// removidos vão para uma lista de nós livres que usa a mesma técnica. Como a
+// memória dos nós nunca é devolvida ao sistema enquanto a pilha está em uso,
+// ler um nó que outra thread acabou de remover é sempre seguro.
+#define NIL UINT32_MAX // Índice nulo.
+#define BITS_BLOCO 16 // Cada bloco tem 2^16 nós (1 MiB).
+#define TAM_BLOCO (UINT32_C(1) << BITS_BLOCO)
+#define NUM_BLOCOS 4096 // Até 2^28 nós ao mesmo tempo.
+#define LINHA_CACHE 64 // Tamanho de uma linha de cache.
+
+typedef struct No {
+	Pokemon *elemento;
+	_Atomic uint32_t prox; // Índice do próximo nó, ou NIL.
+} No;
+
+// Índice de um nó (32 bits menos significativos) junto de uma etiqueta.
+typedef uint64_t Etiquetado;
+#define ETQ_NOVO(idx, etq) (((uint64_t)(uint32_t)(etq) << 32) | (idx))
+#define ETQ_IDX(e) ((uint32_t)(e))
+#define ETQ_TAG(e) ((uint32_t)((e) >> 32))
+
+typedef struct PilhaPokemon {
+	// Campos disputados ficam em linhas de cache separadas.
+	_Alignas(LINHA_CACHE) _Atomic Etiquetado topo; // Topo da pilha.
+	_Alignas(LINHA_CACHE) _Atomic Etiquetado livres; // Nós livres.
+	_Alignas(LINHA_CACHE) _Atomic uint32_t usados; // Nós já recortados.
+	_Atomic(No *) blocos[NUM_BLOCOS]; // Diretório de blocos de nós.
+} PilhaPokemon;
+
+// Pilha sequencial protegida por uma trava global, usada só como referência
+// no teste de desempenho.
+typedef struct {
+	pthread_mutex_t trava;
+	Pokemon **arr; // Array de ponteiros.
+	int n, cap; // Número de elementos e capacidade do array.
+} PilhaTravada;
+
+// Estado compartilhado por uma rodada do teste de estresse.
+typedef struct {
+	void *pilha; // Pilha sob teste.
+	void (*insere)(void *pilha, Pokemon *x);
+	Pokemon *(*remove)(void *pilha); // Retorna NULL se estiver vazia.
+	Pokemon **catalogo; // Pokémon empilhados pelos produtores.
+	int num_catalogo;
+	long por_produtor; // Pokémon empilhados por cada produtor.
+	_Atomic int produtores_ativos;
+	_Atomic long consumidos; // Pokémon desempilhados.
+	_Atomic long soma_ids; // Soma dos ids dos Pokémon desempilhados.
+} Rodada;
+
+// Argumento de cada thread de uma rodada.
+typedef struct {
+	Rodada *rodada;
+	int id; // Número da thread na rodada.
+} Tarefa;
+
+/// Declarações de todas as funções. //////////////////////////////////////////
+
+// Funções para cumprimento da questão.
+int main(int argc, char **argv);
+
+// Funções para a implementação do objeto Pokémon.
+void ler(Pokemon *restrict p, char *str);
+void imprimir(Pokemon *restrict const p);
+Pokemon *pokemon_from_str(char *str);
+Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
+			     const char *description, const PokeType type[2],
+			     const PokeAbilities *abilities, double weight_kg,
+			     double height_m, uint16_t capture_rate,
+			     bool is_legendary, Date capture_date);
+Pokemon *pokemon_clone(const Pokemon *p);
+static inline Pokemon *pokemon_new(void);
+void pokemon_free(Pokemon *restrict p);
+static PokeAbilities abilities_from_string(char *str);
+static PokeType type_from_string(const char *str);
+static const char *type_to_string(PokeType type);
+
+// Funções para a implementação da pilha.
+static inline No *no_em(PilhaPokemon *l, uint32_t i);
+static void treiber_push(PilhaPokemon *l, _Atomic Etiquetado *topo, uint32_t i);
+static uint32_t treiber_pop(PilhaPokemon *l, _Atomic Etiquetado *topo);
+static uint32_t no_aloca(PilhaPokemon *l);
+PilhaPokemon *pilha_new(void);
+void pilha_free(PilhaPokemon *l);
+void pilha_insere(PilhaPokemon *l, Pokemon *x);
+Pokemon *tentar_pop(PilhaPokemon *l);
+void push(PilhaPokemon *l, Pokemon *x);
+Pokemon *pop(PilhaPokemon *l);
+void pilha_print(PilhaPokemon *l);
+static uint32_t no_inverte(PilhaPokemon *l, uint32_t i);
+
+// Funções para o teste de estresse e de desempenho.
+static void travada_insere(void *p, Pokemon *x);
+static Pokemon *travada_remove(void *p);
+static void livre_insere(void *p, Pokemon *x);
+static Pokemon *livre_remove(void *p);
+static void *produtor(void *arg);
+static void *consumidor(void *arg);
+static bool rodada(const char *nome, Rodada *r, int num_prod, int num_cons);
+static int estresse(Pokemon **catalogo, int num_catalogo, int num_prod,
+		    int num_cons, long por_produtor);
+
+/// Métodos que operam nos Pokémon. ///////////////////////////////////////////
+
+// Lê um Pokémon a partir de uma string. A string é modificada.
+void ler(Pokemon *restrict p, char *str)
+{
+	// Posição inicial dos termos após a lista de habilidades. Necessária
+	// porque o método `abilities_from_string()` invalidará a string `str`
+	// antes dessa posição.
+	char *const post_list = strstr(str, "']\",") + 3;
+	char *tok = NULL; // Ponteiro temporário para as substrings (tokens).
+	char *sav = NULL; // Ponteiro auxiliar para o estado de `strtok_r()`.
+	int tok_count = 0; // Contador auxiliar de tokens.
+
+	// Verifica erro ao buscar a substring.
+	if (!post_list) {
+		int errsv = errno;
+		perror("Tentei criar Pokémon com uma string mal formada");
+		exit(errsv);
+	}
+
+	// Lê a chave (id) e a geração.
+	p->id = atoi(strtok_r(str, ",", &sav));
+	p->generation = atoi(strtok_r(NULL, ",", &sav));
+
+	// Lê o nome.
+	tok = strtok_r(NULL, ",", &sav);
+	p->name = strdup(tok);
+
+	// Lê a descrição.
+	tok = strtok_r(NULL, ",", &sav);
+	p->description = strdup(tok);
+
+	// Lê o primeiro tipo.
+	p->type[0] = type_from_string(strtok_r(NULL, ",", &sav));
+
+	// Lẽ o segundo tipo, se existir.
+	tok = strtok_r(NULL, "[,", &sav);
+	p->type[1] = (*tok == '"') ? NO_TYPE : type_from_string(tok);
+
+	// Lê a lista de habilidades.
+	p->abilities = abilities_from_string(strtok_r(NULL, "]", &sav));
+	str = post_list; // Avança para após a lista de habilidades.
+	sav = NULL; // Reseta o ponteiro de `strtok_r()`.
+
+	// Leia peso e altura, se existirem (alguns Pokémon no CSV não têm, mas
+	// todos que têm peso também têm altura, e vice-versa). Por isso,
+	// determina quantos campos não vazios restam.
+	for (int i = 0; str[i]; ++i)
+		// Vírgulas não-consecutivas indicam campo não vazio.
+		if (str[i] == ',' && str[i + 1] != ',')
+			++tok_count;
+
+	// Leia peso e altura, se existirem (alguns Pokémon no CSV não têm, mas
+	// todos que têm peso também têm altura, e vice-versa).
+	if (tok_count == 5) { // Se restam 5 itens, o peso e a altura existem.
+		p->weight = atof(strtok_r(str, ",", &sav));
+		p->height = atof(strtok_r(NULL, ",", &sav));
+	} else {
+		p->height = p->weight = 0; // Atribui um peso inválido.
+	}
+
+	// Lê o determinante da probabilidade de captura e se é lendário ou não.
+	p->capture_rate = atoi(strtok_r(sav ? NULL : str, ",", &sav));
+	p->is_legendary = atoi(strtok_r(NULL, ",", &sav));
+
+	// Lê a data de captura.
+	p->capture_date.d = atoi(strtok_r(NULL, "/", &sav));
+	p->capture_date.m = atoi(strtok_r(NULL, "/", &sav));
+	p->capture_date.y = atoi(strtok_r(NULL, "/\n\r", &sav));
+}
+
+// Printa um Pokémon recebido por referência em `stdout`.
+void imprimir(Pokemon *restrict const p)
+{
+	printf("[#%d -> %s: %s - ['%s'", p->id, p->name, p->description,
+	       type_to_string(p->type[0]));
+
+	if (p->type[1] != NO_TYPE)
+		printf(", '%s'", type_to_string(p->type[1]));
+
+	printf("] - ['%s'", p->abilities.list[0]);
+	for (int i = 1; i < p->abilities.num; ++i)
+		printf(", '%s'", p->abilities.list[i]);
+
+	printf("] - %0.1lfkg - %0.1lfm - %u%% - %s - %u gen] - %02u/%02u/%04u\n",
+	       p->weight, p->height, p->capture_rate,
+	       p->is_legendary ? "true" : "false", p->generation,
+	       p->capture_date.d, p->capture_date.m, p->capture_date.y);
+}
+
+// Aloca um Pokémon a partir de uma string.
+Pokemon *pokemon_from_str(char *str)
+{
+	Pokemon *res = pokemon_new();
+	ler(res, str);
+	return res;
+}
+
+// Aloca um Pokémon a partir de parâmetros.
+Pokemon *pokemon_from_params(uint16_t id, uint8_t generation, const char *name,
+			     const char *description, const PokeType type[2],
+			     const PokeAbilities *abilities, double weight_kg,
+			     double height_m, uint16_t capture_rate,
+			     bool is_legendary, Date capture_date)
+{
+	Pokemon *res = pokemon_new();
+
+	// Precisamos criar uma cópia profunda da lista de habilidades.
+	PokeAbilities ablist_clone = { .num = abilities->num };
+	ablist_clone.list = malloc(ablist_clone.num * sizeof(char *));
+	for (int i = 0; i < ablist_clone.num; ++i)
+		ablist_clone.list[i] = strdup(abilities->list[i]);
+
+	*res = (Pokemon){ .id = id,
+			  .generation = generation,
+			  .name = strdup(name),
+			  .description = strdup(description),
+			  .type[0] = type[0],
+			  .type[1] = type[1],
+			  .abilities = ablist_clone,
+			  .weight = weight_kg,
+			  .height = height_m,
+			  .capture_rate = capture_rate,
+			  .is_legendary = is_legendary,
+			  .capture_date = capture_date };
+	return res;
+}
+
+// Duplica um Pokemón.
+Pokemon *pokemon_clone(const Pokemon *p)
+{
+	return pokemon_from_params(p->id, p->generation, p->name,
+				   p->description, p->type, &p->abilities,
+				   p->weight, p->height, p->capture_rate,
+				   p->is_legendary, p->capture_date);
+}
+
+// Aloca um Pokémon vazio dinamicamente.
+static inline Pokemon *pokemon_new(void)
+{
+	Pokemon *res = calloc(1, sizeof(Pokemon));
+	if (!res) {
+		int errsv = errno;
+		perror("Impossível alocar memória para Pokémon");
+		exit(errsv);
+	}
+	return res;
+}
+
+// Libera um Pokémon alocado dinamicamente.
+void pokemon_free(Pokemon *restrict p)
+{
+	if (p != NULL) {
+		free(p->name);
+		free(p->description);
+		for (int i = 0; i < p->abilities.num; ++i)
+			free(p->abilities.list[i]);
+		free(p->abilities.list);
+		free(p);
+	}
+}
+
+// Cria uma lista dinâmica de habilidades a partir de uma representação textual.
+static PokeAbilities abilities_from_string(char *str)
+{
+	PokeAbilities res = { .num = 1 }; // Há no mínimo uma habilidade.
+	char *sav = NULL;
+
+	// Conta o número de habilidades a partir das vírgulas na string.
+	for (int i = 0; str[i] && str[i] != ']'; ++i)
+		if (str[i] == ',')
+			++res.num;
+	// Aloca memória para a lista dinâmica.
+	res.list = malloc(res.num * sizeof(char *));
+	if (!res.list) {
+		int errsv = errno;
+		perror("Impossível alocar memória para lista de habilidades");
+		exit(errsv);
+	}
+
+	// Lê cada uma das habilidades.
+	for (int i = 0; i < res.num; ++i) {
+		char *ability; // Ponteiro temporário para a substring (token).
+		int token_len = 0; // Contador to tamanho do token `ability`.
+
+		// Extrai um token da lista.
+		ability = strtok_r(i ? NULL : str, ",]", &sav);
+		if (!ability) {
+			int errsv = errno;
+			for (int j = 0; j < i; ++j) {
+				free(res.list[j]);
+			}
+			free(res.list);
+			res.list = NULL;
+			res.num = 0;
+			perror("Erro ao extrair habilidade da string");
+			exit(errsv);
+		}
+
+		// Remove quaisquer caracteres exceto letras, números e espaços.
+		for (int j = 0; ability[j]; ++j)
+			if (isalnum(ability[j]) || isspace(ability[j]))
+				ability[token_len++] = ability[j];
+		ability[token_len] = '\0'; // Termina o token.
+
+		// Remove espaços e aspas iniciais.
+		while (*ability == ' ' || *ability == '\'') {
+			++ability;
+			--token_len;
+		}
+
+		// Remove espaços e aspas finais.
+		while (token_len > 0 && (ability[token_len - 1] == ' ' ||
+					 ability[token_len - 1] == '\''))
+			ability[--token_len] = '\0';
+
+		// Aloca a memória para a habilidade e a salva no struct.
+		res.list[i] = strdup(ability);
+		if (!res.list[i]) {
+			int errsv = errno;
+			for (int j = 0; j < i; ++j) {
+				free(res.list[j]);
+			}
+			free(res.list);
+			res.list = NULL;
+			res.num = 0;
+			perror("Impossível alocar memória para habilidade");
+			exit(errsv);
+		}
+	}
+
+	return res;
+}
+
+// Converte a representação textual do tipo em um dado PokeType.
+static PokeType type_from_string(const char *str)
+{
+	enum PokeType res;
+
+	if (!strcmp(str, "bug"))
+		res = BUG;
+	else if (!strcmp(str, "dark"))
+		res = DARK;
+	else if (!strcmp(str, "dragon"))
+		res = DRAGON;
+	else if (!strcmp(str, "electric"))
+		res = ELECTRIC;
+	else if (!strcmp(str, "fairy"))
+		res = FAIRY;
+	else if (!strcmp(str, "fighting"))
+		res = FIGHTING;
+	else if (!strcmp(str, "fire"))
+		res = FIRE;
+	else if (!strcmp(str, "flying"))
+		res = FLYING;
+	else if (!strcmp(str, "ghost"))
+		res = GHOST;
+	else if (!strcmp(str, "grass"))
+		res = GRASS;
+	else if (!strcmp(str, "ground"))
+		res = GROUND;
+	else if (!strcmp(str, "ice"))
+		res = ICE;
+	else if (!strcmp(str, "normal"))
+		res = NORMAL;
+	else if (!strcmp(str, "poison"))
+		res = POISON;
+	else if (!strcmp(str, "psychic"))
+		res = PSYCHIC;
+	else if (!strcmp(str, "rock"))
+		res = ROCK;
+	else if (!strcmp(str, "steel"))
+		res = STEEL;
+	else if (!strcmp(str, "water"))
+		res = WATER;
+	else
+		res = NO_TYPE;
+
+	return res;
+}
+
+// Converte um dado PokeType em sua representação textual.
+static const char *type_to_string(PokeType type)
+{
+	const char *res = NULL;
+	switch (type) {
+	case BUG:
+		res = "bug";
+		break;
+	case DARK:
+		res = "dark";
+		break;
+	case DRAGON:
+		res = "dragon";
+		break;
+	case ELECTRIC:
+		res = "electric";
+		break;
+	case FAIRY:
+		res = "fairy";
+		break;
+	case FIGHTING:
+		res = "fighting";
+		break;
+	case FIRE:
+		res = "fire";
+		break;
+	case FLYING:
+		res = "flying";
+		break;
+	case GHOST:
+		res = "ghost";
+		break;
+	case GRASS:
+		res = "grass";
+		break;
+	case GROUND:
+		res = "ground";
+		break;
+	case ICE:
+		res = "ice";
+		break;
+	case NORMAL:
+		res = "normal";
+		break;
+	case POISON:
+		res = "poison";
+		break;
+	case PSYCHIC:
+		res = "psychic";
+		break;
+	case ROCK:
+		res = "rock";
+		break;
+	case STEEL:
+		res = "steel";
+		break;
+	case WATER:
+		res = "water";
+		break;
+	default:
+		fputs("FATAL: Pokémon tem um tipo desconhecido!\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return res;
+}
+
+/// Métodos que operam na pilha concorrente de Pokémon. ///////////////////////
+
+// Retorna o nó de índice `i`.
+static inline No *no_em(PilhaPokemon *l, uint32_t i)
+{
+	No *bloco = atomic_load_explicit(&l->blocos[i >> BITS_BLOCO],
+					 memory_order_acquire);
+	return bloco + (i & (TAM_BLOCO - 1));
+}
+
+// Empilha o nó `i` na pilha de Treiber cujo topo é `topo`.
+static void treiber_push(PilhaPokemon *l, _Atomic Etiquetado *topo, uint32_t i)
+{
+	No *no = no_em(l, i);
+	Etiquetado velho = atomic_load_explicit(topo, memory_order_relaxed);
+	Etiquetado novo;
+
+	do {
+		atomic_store_explicit(&no->prox, ETQ_IDX(velho),
+				      memory_order_relaxed);
+		novo = ETQ_NOVO(i, ETQ_TAG(velho) + 1);
+	} while (!atomic_compare_exchange_weak_explicit(topo, &velho, novo,
+							memory_order_release,
+							memory_order_relaxed));
+}
+
+// Desempilha um nó da pilha de Treiber cujo topo é `topo`, retornando seu
+// índice, ou NIL se ela estiver vazia. O nó lido pode ter acabado de ser
+// removido por outra thread, mas sua memória continua válida, e a etiqueta
+// faz o CAS falhar nesse caso.
+static uint32_t treiber_pop(PilhaPokemon *l, _Atomic Etiquetado *topo)
+{
+	Etiquetado velho = atomic_load_explicit(topo, memory_order_acquire);
+	Etiquetado novo;
+	uint32_t prox;
+
+	do {
+		if (ETQ_IDX(velho) == NIL)
+			return NIL;
+
+		prox = atomic_load_explicit(&no_em(l, ETQ_IDX(velho))->prox,
+					    memory_order_relaxed);
+		novo = ETQ_NOVO(prox, ETQ_TAG(velho) + 1);
+	} while (!atomic_compare_exchange_weak_explicit(topo, &velho, novo,
+							memory_order_acquire,
+							memory_order_acquire));
+
+	return ETQ_IDX(velho);
+}
+
+// Obtém um nó livre, reaproveitando um devolvido ou recortando um novo dos
+// blocos, e retorna seu índice. Se várias threads precisarem do mesmo bloco
+// ao mesmo tempo, só uma o instala, e as outras descartam os seus.
+static uint32_t no_aloca(PilhaPokemon *l)
+{
+	uint32_t i = treiber_pop(l, &l->livres);
+	No *bloco, *esperado = NULL;
+	_Atomic(No *) *dir;
+
+	if (i != NIL)
+		return i;
+
+	i = atomic_fetch_add_explicit(&l->usados, 1, memory_order_relaxed);
+	if (i >= NUM_BLOCOS * TAM_BLOCO) {
+		fputs("A pilha atingiu o número máximo de nós.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	dir = &l->blocos[i >> BITS_BLOCO];
+	if (!atomic_load_explicit(dir, memory_order_acquire)) {
+		bloco = calloc(TAM_BLOCO, sizeof(No));
+
+		// Trata erro na alocação.
+		if (bloco == NULL) {
+			int errsv = errno;
+			perror("Impossível alocar memória para bloco de nós");
+			exit(errsv);
+		}
+
+		if (!atomic_compare_exchange_strong_explicit(
+			    dir, &esperado, bloco, memory_order_acq_rel,
+			    memory_order_acquire))
+			free(bloco);
+	}
+
+	return i;
+}
+
+// Instancia uma pilha de Pokémon.
+PilhaPokemon *pilha_new(void)
+{
+	PilhaPokemon *res = aligned_alloc(_Alignof(PilhaPokemon), sizeof(*res));
+
+	// Trata erro na alocação.
+	if (res == NULL) {
+		int errsv = errno;
+		perror("Impossível alocar memória para pilha");
+		exit(errsv);
+	}
+
+	atomic_init(&res->topo, ETQ_NOVO(NIL, 0));
+	atomic_init(&res->livres, ETQ_NOVO(NIL, 0));
+	atomic_init(&res->usados, 0);
+	for (int i = 0; i < NUM_BLOCOS; ++i)
+		atomic_init(&res->blocos[i], NULL);
+
+	return res;
+}
+
+// Libera a pilha de Pokémon, e todos os Pokémon contidos. Nenhuma outra
+// thread pode estar usando a pilha.
+void pilha_free(PilhaPokemon *l)
+{
+	for (uint32_t i = ETQ_IDX(atomic_load(&l->topo)); i != NIL;
+	     i = atomic_load(&no_em(l, i)->prox))
+		pokemon_free(no_em(l, i)->elemento);
+
+	// Só agora a memória dos nós é devolvida ao sistema.
+	for (int i = 0; i < NUM_BLOCOS; ++i)
+		free(atomic_load(&l->blocos[i]));
+}
+
+// Empilha o próprio ponteiro `x`, sem duplicá-lo. Pode ser chamada por várias
+// threads ao mesmo tempo.
+void pilha_insere(PilhaPokemon *l, Pokemon *x)
+{
+	uint32_t i = no_aloca(l);
+
+	no_em(l, i)->elemento = x;
+	treiber_push(l, &l->topo, i);
+}
+
+// Desempilha um Pokémon, ou retorna NULL se a pilha estiver vazia. Pode ser
+// chamada por várias threads ao mesmo tempo.
+Pokemon *tentar_pop(PilhaPokemon *l)
+{
+	uint32_t i = treiber_pop(l, &l->topo);
+	Pokemon *res;
+
+	if (i == NIL)
+		return NULL;
+
+	res = no_em(l, i)->elemento;
+	treiber_push(l, &l->livres, i);
+	return res;
+}
+
+// Função de inserção na pilha. O Pokémon inserido é duplicado.
+void push(PilhaPokemon *l, Pokemon *x)
+{
+	pilha_insere(l, pokemon_clone(x));
+}
+
+// Função de remoção da pilha.
+Pokemon *pop(PilhaPokemon *l)
+{
+	Pokemon *res = tentar_pop(l);
+
+	if (!res) {
+		fputs("A pilha está vazia.\n", stderr);
+		exit(EXIT_FAILURE);
+	}
+
+	return res;
+}
+
+// Funções de impreção da pilha. Nenhuma outra thread pode estar usando a
+// pilha. A cadeia é invertida para ser percorrida da base para o topo sem
+// recursão, e depois desinvertida, o que preserva o topo e sua etiqueta.
+void pilha_print(PilhaPokemon *l)
+{
+	uint32_t base = no_inverte(l, ETQ_IDX(atomic_load(&l->topo)));
+	int pos = 0;
+
+	for (uint32_t i = base; i != NIL; i = atomic_load(&no_em(l, i)->prox)) {
+		printf("[%d] ", pos++);
+		imprimir(no_em(l, i)->elemento);
+	}
+
+	no_inverte(l, base);
+}
+
+// Inverte a cadeia de nós que começa em `i`, retornando seu novo início.
+static uint32_t no_inverte(PilhaPokemon *l, uint32_t i)
+{
+	uint32_t ant = NIL;
+
+	while (i != NIL) {
+		uint32_t prox = atomic_load(&no_em(l, i)->prox);
+		atomic_store(&no_em(l, i)->prox, ant);
+		ant = i;
+		i = prox;
+	}
+
+	return ant;
+}
+
+/// Teste de estresse e de desempenho. ////////////////////////////////////////
+
+// Insere na pilha travada, crescendo o arranjo se necessário.
+static void travada_insere(void *p, Pokemon *x)
+{
+	PilhaTravada *l = p;
+
+	pthread_mutex_lock(&l->trava);
+	if (l->n == l->cap) {
+		int cap = l->cap ? 2 * l->cap : 8;
+		Pokemon **arr = realloc(l->arr, sizeof(Pokemon *[cap]));
+
+		// Trata erro na alocação.
+		if (arr == NULL) {
+			int errsv = errno;
+			perror("Impossível alocar memória para array");
+			exit(errsv);
+		}
+
+		l->arr = arr;
+		l->cap = cap;
+	}
+	l->arr[l->n++] = x;
+	pthread_mutex_unlock(&l->trava);
+}
+
+// Remove da pilha travada, ou retorna NULL se ela estiver vazia.
+static Pokemon *travada_remove(void *p)
+{
+	PilhaTravada *l = p;
+	Pokemon *res = NULL;
+
+	pthread_mutex_lock(&l->trava);
+	if (l->n)
+		res = l->arr[--l->n];
+	pthread_mutex_unlock(&l->trava);
+
+	return res;
+}
+
+// Adaptadores da pilha concorrente para a interface das rodadas.
+static void livre_insere(void *p, Pokemon *x)
+{
+	pilha_insere(p, x);
+}
+
+static Pokemon *livre_remove(void *p)
+{
+	return tentar_pop(p);
+}
+
+// Produtor: empilha `por_produtor` Pokémon do catálogo.
+static void *produtor(void *arg)
+{
+	Tarefa *t = arg;
+	Rodada *r = t->rodada;
+
+	for (long j = 0; j < r->por_produtor; ++j)
+		r->insere(r->pilha,
+			  r->catalogo[(t->id * r->por_produtor + j) %
+				      r->num_catalogo]);
+
+	atomic_fetch_sub(&r->produtores_ativos, 1);
+	return NULL;
+}
+
+// Consumidor: desempilha até que os produtores terminem e a pilha esvazie,
+// somando quantos Pokémon removeu e seus ids.
+static void *consumidor(void *arg)
+{
+	Tarefa *t = arg;
+	Rodada *r = t->rodada;
+	long num = 0, soma = 0;
+
+	for (;;) {
+		Pokemon *p = r->remove(r->pilha);
+
+		// Se a pilha parece vazia, só termina quando nenhum produtor
+		// puder mais empilhar e ela continuar vazia.
+		if (!p) {
+			if (atomic_load(&r->produtores_ativos))
+				continue;
+			if (!(p = r->remove(r->pilha)))
+				break;
+		}
+
+		num += 1;
+		soma += p->id;
+	}
+
+	atomic_fetch_add(&r->consumidos, num);
+	atomic_fetch_add(&r->soma_ids, soma);
+	return NULL;
+}
+
+// Executa uma rodada com `num_prod` produtores e `num_cons` consumidores,
+// verifica que cada Pokémon empilhado foi desempilhado exatamente uma vez, e
+// mostra a vazão. Retorna se a verificação teve sucesso.
+static bool rodada(const char *nome, Rodada *r, int num_prod, int num_cons)
+{
+	pthread_t threads[num_prod + num_cons];
+	Tarefa tarefas[num_prod + num_cons];
+	struct timespec ini, fim;
+	long esperados = (long)num_prod * r->por_produtor, soma = 0;
+	double seg;
+
+	// Calcula a soma dos ids que os produtores vão empilhar.
+	for (long j = 0; j < esperados; ++j)
+		soma += r->catalogo[j % r->num_catalogo]->id;
+
+	atomic_store(&r->produtores_ativos, num_prod);
+	atomic_store(&r->consumidos, 0);
+	atomic_store(&r->soma_ids, 0);
+
+	clock_gettime(CLOCK_MONOTONIC, &ini);
+	for (int i = 0; i < num_prod + num_cons; ++i) {
+		int err;
+
+		tarefas[i] = (Tarefa){ .rodada = r, .id = i };
+		err = pthread_create(&threads[i], NULL,
+				     i < num_prod ? produtor : consumidor,
+				     &tarefas[i]);
+
+		// Trata erro na criação da thread.
+		if (err) {
+			errno = err;
+			perror("Impossível criar thread");
+			exit(err);
+		}
+	}
+	for (int i = 0; i < num_prod + num_cons; ++i)
+		pthread_join(threads[i], NULL);
+	clock_gettime(CLOCK_MONOTONIC, &fim);
+
+	seg = (fim.tv_sec - ini.tv_sec) + (fim.tv_nsec - ini.tv_nsec) / 1e9;
+	printf("%s: %d produtores, %d consumidores, %ld operações em %.3lf s "
+	       "(%.2lf Mop/s)\n",
+	       nome, num_prod, num_cons, 2 * esperados, seg,
+	       2 * esperados / seg / 1e6);
+
+	if (atomic_load(&r->consumidos) != esperados ||
+	    atomic_load(&r->soma_ids) != soma || r->remove(r->pilha)) {
+		fprintf(stderr, "%s: esperava %ld Pokémon (soma dos ids %ld), "
+				"mas foram removidos %ld (soma dos ids %ld).\n",
+			nome, esperados, soma, atomic_load(&r->consumidos),
+			atomic_load(&r->soma_ids));
+		return false;
+	}
+
+	return true;
+}
+
+// Compara a pilha concorrente com uma pilha protegida por uma trava global,
+// sob a mesma carga. Retorna o código de saída do programa.
+static int estresse(Pokemon **catalogo, int num_catalogo, int num_prod,
+		    int num_cons, long por_produtor)
+{
+	PilhaPokemon *livre = pilha_new();
+	PilhaTravada travada = { .arr = NULL, .n = 0, .cap = 0 };
+	Rodada r = { .catalogo = catalogo,
+		     .num_catalogo = num_catalogo,
+		     .por_produtor = por_produtor };
+	bool ok;
+
+	if (num_prod < 1 || num_cons < 1 || por_produtor < 1 ||
+	    num_catalogo < 1) {
+		fputs("Parâmetros inválidos para o teste de estresse.\n",
+		      stderr);
+		return EXIT_FAILURE;
+	}
+
+	r.pilha = livre;
+	r.insere = livre_insere;
+	r.remove = livre_remove;
+	ok = rodada("Sem trava", &r, num_prod, num_cons);
+
+	pthread_mutex_init(&travada.trava, NULL);
+	r.pilha = &travada;
+	r.insere = travada_insere;
+	r.remove = travada_remove;
+	ok = rodada("Trava global", &r, num_prod, num_cons) && ok;
+	pthread_mutex_destroy(&travada.trava);
+
+	// As pilhas estão vazias, e os Pokémon pertencem ao catálogo.
+	free(travada.arr);
+	pilha_free(livre);
+	free(livre);
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/// Programa principal. ///////////////////////////////////////////////////////
+
+#define NUM_PK 801 // Número máximo de Pokémon no CSV.
+#define TAM_SAIDA (1 << 16) // Tamanho do buffer da saída padrão.
+
+int main(int argc, char **argv)
+{
+	// Stream do arquivo CSV.
+	FILE *csv = fopen((argc > 1) ? argv[1] : DEFAULT_DB, "r");
+	Pokemon *pokemon[NUM_PK] = { NULL }; // Array de Pokémon.
+	PilhaPokemon *pilha = NULL; // Pokémon selecionados.
+	int num_lidos = 0; // Número de Pokémon lidos.
+	char *input = NULL; // Buffer para as linhas de entrada.
+	size_t tam_input = 0; // Capacidade do buffer de entrada.
+	char cmd[10]; // Buffer para a leitura dos comandos.
+
+	// Usa um buffer de saída grande, para que imprimir pilhas profundas
+	// faça poucas chamadas de sistema.
+	setvbuf(stdout, NULL, _IOFBF, TAM_SAIDA);
+
+	// Verifica se houve erro ao abrir o CSV.
+	if (!csv) {
+		int errsv = errno;
+		perror("Falha ao abrir CSV");
+		return errsv;
+	}
+
+	// Descarta a primeira linha (cabeçalho).
+	while (fgetc(csv) != '\n')
+		;
+
+	// Lê os Pokémon do CSV.
+	while (num_lidos < NUM_PK && getline(&input, &tam_input, csv) != -1)
+		pokemon[num_lidos++] = pokemon_from_str(input);
+	fclose(csv); // Fecha o arquivo ao terminar.
+
+	// Com `-t PRODUTORES CONSUMIDORES N` após o CSV, executa o teste de
+	// estresse em vez de ler comandos da entrada padrão.
+	if (argc == 6 && !strcmp(argv[2], "-t")) {
+		int res = estresse(pokemon, num_lidos, atoi(argv[3]),
+				   atoi(argv[4]), atol(argv[5]));
+
+		free(input);
+		for (int i = 0; i < num_lidos; ++i)
+			pokemon_free(pokemon[i]);
+		return res;
+	}
+
+	// Inicializa a pilha flexível verificando erro.
+	pilha = pilha_new();
+
+	// Lê os índices da entrada padrão e adiciona à pilha.
+	while (getline(&input, &tam_input, stdin) != -1 &&
+	       strcmp(input, "FIM\n"))
+		push(pilha, pokemon[atoi(input) - 1]);
+	free(input); // Libera o buffer dinâmico de entrada.
+
+	// Lê os comandos de inserção e remoção da pilha.
+	while (scanf("%s", cmd) != EOF) {
+		if (*cmd == 'I') { // Caso de inserção.
+			int idx; // Índice do Pokémon a inserir.
+			scanf("%d", &idx); // Lê o ID do Pokémon.
+			--idx; // Decrementa para encontrar índice.
+
+			push(pilha, pokemon[idx]);
+		} else if (*cmd == 'R') {
+			// Mostra o Pokémon removido.
+			printf("(R) %s\n", pop(pilha)->name);
+		}
+	}
+
+	// Libera o arranjo original.
+	for (int i = 0; i < num_lidos; ++i)
+		pokemon_free(pokemon[i]);
+
+	// Exibe o resultado.
+	pilha_print(pilha);
+
+	// Libera a pilha.
+	pilha_free(pilha);
+	free(pilha);
+	return EXIT_SUCCESS;
+}
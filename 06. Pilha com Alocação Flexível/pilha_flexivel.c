@@ -90,8 +90,26 @@ typedef struct Celula {
 	struct Celula *prox;
 } Celula;
 
+// Página do pool de células. As células são recortadas de páginas grandes, de
+// modo que células vizinhas na estrutura tendem a ficar vizinhas na memória.
+#define CELULAS_POR_PAGINA 4096 // Cada página ocupa 64 KiB.
+
+typedef struct Pagina {
+	struct Pagina *prox; // Próxima página do pool.
+	Celula celulas[CELULAS_POR_PAGINA];
+} Pagina;
+
+// Pool de células. As células devolvidas formam uma lista encadeada pelo
+// próprio campo `prox`, e são reaproveitadas antes de recortar novas.
+typedef struct {
+	Pagina *paginas; // Páginas alocadas; a primeira é a atual.
+	Celula *livres; // Lista de células devolvidas.
+	int usadas; // Células já recortadas da página atual.
+} PoolCelulas;
+
 typedef struct PilhaPokemon {
 	Celula *topo;
+	PoolCelulas pool; // Origem de todas as células da pilha.
 } PilhaPokemon;
 
 /// Declarações de todas as funções. //////////////////////////////////////////
@@ -115,13 +133,18 @@ static PokeAbilities abilities_from_string(char *str);
 static PokeType type_from_string(const char *str);
 static const char *type_to_string(PokeType type);
 
+// Funções para a implementação do pool de células.
+static Celula *pool_aloca(PoolCelulas *p);
+static void pool_devolve(PoolCelulas *p, Celula *c);
+static void pool_free(PoolCelulas *p);
+
 // Funções para a implementação da pilha.
 PilhaPokemon *pilha_new(void);
 void pilha_free(PilhaPokemon *l);
 void push(PilhaPokemon *l, Pokemon *x);
 Pokemon *pop(PilhaPokemon *l);
 void pilha_print(PilhaPokemon *l);
-static int pilha_print_aux(Celula *i);
+static Celula *celula_inverte(Celula *i);
 
 /// Métodos que operam nos Pokémon. ///////////////////////////////////////////
 
@@ -471,6 +494,57 @@ static const char *type_to_string(PokeType type)
 	return res;
 }
 
+/// Métodos que operam no pool de células. ////////////////////////////////////
+
+// Obtém uma célula zerada do pool, reaproveitando uma devolvida se houver.
+static Celula *pool_aloca(PoolCelulas *p)
+{
+	Celula *ret = p->livres;
+
+	if (ret) {
+		p->livres = ret->prox;
+	} else {
+		// Aloca uma nova página se a atual já foi toda recortada.
+		if (!p->paginas || p->usadas == CELULAS_POR_PAGINA) {
+			Pagina *pag = malloc(sizeof(*pag));
+
+			// Trata erro na alocação.
+			if (pag == NULL) {
+				int errsv = errno;
+				perror("Impossível alocar página de células");
+				exit(errsv);
+			}
+
+			pag->prox = p->paginas;
+			p->paginas = pag;
+			p->usadas = 0;
+		}
+
+		ret = &p->paginas->celulas[p->usadas++];
+	}
+
+	memset(ret, 0, sizeof(*ret));
+	return ret;
+}
+
+// Devolve uma célula ao pool.
+static void pool_devolve(PoolCelulas *p, Celula *c)
+{
+	c->prox = p->livres;
+	p->livres = c;
+}
+
+// Libera de uma só vez todas as páginas do pool, e todas as suas células.
+static void pool_free(PoolCelulas *p)
+{
+	for (Pagina *i = p->paginas, *prox; i; i = prox) {
+		prox = i->prox;
+		free(i);
+	}
+
+	memset(p, 0, sizeof(*p));
+}
+
 /// Métodos que operam na pilha flexível de Pokémon. //////////////////////////
 
 // Instancia uma pilha de Pokémon.
@@ -485,7 +559,7 @@ PilhaPokemon *pilha_new(void)
 		exit(errsv);
 	}
 
-	res->topo = NULL;
+	*res = (PilhaPokemon){ .topo = NULL };
 
 	return res;
 }
@@ -493,24 +567,17 @@ PilhaPokemon *pilha_new(void)
 // Libera a pilha de Pokémon, e todos os Pokémon contidos.
 void pilha_free(PilhaPokemon *l)
 {
-	for (Celula *i = l->topo, *prox; i; i = prox) {
-		prox = i->prox;
+	for (Celula *i = l->topo; i; i = i->prox)
 		pokemon_free(i->elemento);
-		free(i);
-	}
+
+	// As células são liberadas de uma vez, junto com as páginas do pool.
+	pool_free(&l->pool);
 }
 
 // Função de inserção na pilha. O Pokémon inserido é duplicado.
 void push(PilhaPokemon *l, Pokemon *x)
 {
-	Celula *tmp = malloc(sizeof(*tmp));
-
-	// Trata erro na alocação.
-	if (tmp == NULL) {
-		int errsv = errno;
-		perror("Impossível alocar memória para célula");
-		exit(errsv);
-	}
+	Celula *tmp = pool_aloca(&l->pool);
 
 	tmp->elemento = pokemon_clone(x);
 	tmp->prox = l->topo;
@@ -531,33 +598,45 @@ Pokemon *pop(PilhaPokemon *l)
 	res = l->topo->elemento;
 	tmp = l->topo;
 	l->topo = l->topo->prox;
-	free(tmp);
+	pool_devolve(&l->pool, tmp);
 
 	return res;
 }
 
-// Funções de impreção da pilha.
+// Funções de impreção da pilha. A cadeia é invertida para ser percorrida da
+// base para o topo sem recursão, e depois desinvertida.
 void pilha_print(PilhaPokemon *l)
 {
-	pilha_print_aux(l->topo);
+	Celula *base = celula_inverte(l->topo);
+	int pos = 0;
+
+	for (Celula *i = base; i; i = i->prox, ++pos) {
+		printf("[%d] ", pos);
+		imprimir(i->elemento);
+	}
+
+	l->topo = celula_inverte(base);
 }
 
-static int pilha_print_aux(Celula *i)
+// Inverte a cadeia de células que começa em `i`, retornando seu novo início.
+static Celula *celula_inverte(Celula *i)
 {
-	int res = -1;
+	Celula *ant = NULL;
 
-	if (i) {
-		res = 1 + pilha_print_aux(i->prox);
-		printf("[%d] ", res);
-		imprimir(i->elemento);
+	while (i) {
+		Celula *prox = i->prox;
+		i->prox = ant;
+		ant = i;
+		i = prox;
 	}
 
-	return res;
+	return ant;
 }
 
 /// Programa principal. ///////////////////////////////////////////////////////
 
 #define NUM_PK 801 // Número máximo de Pokémon no CSV.
+#define TAM_SAIDA (1 << 16) // Tamanho do buffer da saída padrão.
 
 int main(int argc, char **argv)
 {
@@ -570,6 +649,10 @@ int main(int argc, char **argv)
 	size_t tam_input = 0; // Capacidade do buffer de entrada.
 	char cmd[10]; // Buffer para a leitura dos comandos.
 
+	// Usa um buffer de saída grande, para que imprimir pilhas profundas
+	// faça poucas chamadas de sistema.
+	setvbuf(stdout, NULL, _IOFBF, TAM_SAIDA);
+
 	// Verifica se houve erro ao abrir o CSV.
 	if (!csv) {
 		int errsv = errno;
@@ -11,7 +11,7 @@ DB     := ../pokemon.csv
 # Compilador de C e seus parâmetros.
 CC      := clang
 CFLAGS  := -Werror -Wall -Wextra -pedantic -O3 -g --debug --std=c99
-LDFLAGS := -lm
+LDLIBS  := -lm
 
 # Java, compilador de Java, e seus parâmetros.
 JAVA       := java
@@ -32,9 +32,14 @@ all: $(BIN)
 # Alvos que não são arquivos.
 .PHONY: all clean test testc testjava
 
+# Cada programa em C listado em `CBIN` é testado com a mesma entrada e saída.
 testc: $(CBIN)
-	$(CBIN) $(DB) < $(INPUT) > $(TEST)
-	@$(DIFF) --report-identical-files --strip-trailing-cr $(OUTPUT) $(TEST)
+	@for bin in $(CBIN); do \
+		echo "$$bin $(DB) < $(INPUT) > $(TEST)"; \
+		$$bin $(DB) < $(INPUT) > $(TEST) || exit 1; \
+		$(DIFF) --report-identical-files --strip-trailing-cr \
+			$(OUTPUT) $(TEST) || exit 1; \
+	done
 
 testjava: $(JAVABIN)
 	$(JAVA) $(JAVACLASS) $(DB) < $(INPUT) > $(TEST)